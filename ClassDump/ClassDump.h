@@ -21,10 +21,12 @@ FOUNDATION_EXPORT const unsigned char ClassDumpVersionString[];
 #import <ClassDump/CDClassDumpVisitor.h>
 #import <ClassDump/CDClassFrameworkVisitor.h>
 #import <ClassDump/CDDataCursor.h>
+#import <ClassDump/CDDataView.h>
 //#import <ClassDump/CDExtensions.h>
 #import <ClassDump/CDFatArch.h>
 #import <ClassDump/CDFatFile.h>
 #import <ClassDump/CDFile.h>
+#import <ClassDump/CDMappedData.h>
 #import <ClassDump/CDFindMethodVisitor.h>
 #import <ClassDump/CDLCBuildVersion.h>
 #import <ClassDump/CDLCChainedFixups.h>
@@ -58,10 +60,12 @@ FOUNDATION_EXPORT const unsigned char ClassDumpVersionString[];
 #import <ClassDump/CDLoadCommand.h>
 #import <ClassDump/CDMachOFile.h>
 #import <ClassDump/CDMachOFileDataCursor.h>
+#import <ClassDump/CDSpanCursor.h>
 #import <ClassDump/CDMethodType.h>
 #import <ClassDump/CDMultipleFileVisitor.h>
 #import <ClassDump/CDObjectiveC1Processor.h>
 #import <ClassDump/CDObjectiveC2Processor.h>
+#import <ClassDump/CDObjectiveC2Decoders.h>
 #import <ClassDump/CDObjectiveCProcessor.h>
 #import <ClassDump/CDOCCategory.h>
 #import <ClassDump/CDOCClass.h>
@@ -77,6 +81,8 @@ FOUNDATION_EXPORT const unsigned char ClassDumpVersionString[];
 #import <ClassDump/CDRelocationInfo.h>
 #import <ClassDump/CDSearchPathState.h>
 #import <ClassDump/CDSection.h>
+#import <ClassDump/CDAddressIndex.h>
+#import <ClassDump/CDStringPool.h>
 #import <ClassDump/CDStructureInfo.h>
 #import <ClassDump/CDStructureTable.h>
 #import <ClassDump/CDSymbol.h>
@@ -29,6 +29,7 @@
 @class CDVisitor;
 @class CDSearchPathState;
 @class CDClassDumpConfiguration;
+@class CDObjectiveCCache;
 
 NS_HEADER_AUDIT_BEGIN(nullability, sendability)
 
@@ -46,6 +47,8 @@ extern NSString *CDErrorKey_Exception;
 @property (readonly) BOOL hasObjectiveCRuntimeInfo;
 @property (readonly) CDTypeController *typeController;
 @property (readonly) CDSearchPathState *searchPathState;
+// The cache used by the last -processObjectiveCData, nil unless the configuration has a cache directory.
+@property (readonly, nullable) CDObjectiveCCache *objectiveCCache;
 
 - (BOOL)loadFile:(CDFile *)file error:(NSError **)error;
 
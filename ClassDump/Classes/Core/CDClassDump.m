@@ -9,10 +9,13 @@
 #import <ClassDump/CDFatFile.h>
 #import <ClassDump/CDLCDylib.h>
 #import <ClassDump/CDMachOFile.h>
+#import <ClassDump/CDStringPool.h>
 #import <ClassDump/CDObjectiveCProcessor.h>
+#import <ClassDump/CDObjectiveCCache.h>
 #import <ClassDump/CDType.h>
 #import <ClassDump/CDTypeFormatter.h>
 #import <ClassDump/CDTypeParser.h>
+#import <ClassDump/CDTypeParseCache.h>
 #import <ClassDump/CDVisitor.h>
 #import <ClassDump/CDLCSegment.h>
 #import <ClassDump/CDTypeController.h>
@@ -89,7 +92,13 @@ NSString *CDErrorKey_Exception    = @"CDErrorKey_Exception";
 }
 
 + (BOOL)printFixupData {
-    return [[[NSProcessInfo processInfo] arguments] containsObject:@"-F"];
+    // The arguments don't change, so only scan them once.
+    static BOOL printFixupData = NO;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        printFixupData = [[[NSProcessInfo processInfo] arguments] containsObject:@"-F"];
+    });
+    return printFixupData;
 }
 
 - (BOOL)loadFile:(CDFile *)file error:(NSError *__autoreleasing *)error;
@@ -117,29 +126,11 @@ NSString *CDErrorKey_Exception    = @"CDErrorKey_Exception";
     // Set before processing recursively.  This was getting caught on CoreUI on 10.6
     assert([machOFile filename] != nil);
     [_machOFiles addObject:machOFile];
-    _machOFilesByName[machOFile.filename] = machOFile;
+    [self registerMachOFile:machOFile];
     
     if (_configuration.shouldProcessRecursively) {
         @try {
-            for (CDLoadCommand *loadCommand in [machOFile loadCommands]) {
-                if ([loadCommand isKindOfClass:[CDLCDylib class]]) {
-                    CDLCDylib *dylibCommand = (CDLCDylib *)loadCommand;
-                    if ([dylibCommand cmd] == LC_LOAD_DYLIB) {
-                        [self.searchPathState pushSearchPaths:[machOFile runPaths]];
-                        {
-                            NSString *loaderPathPrefix = @"@loader_path";
-                            
-                            NSString *path = [dylibCommand path];
-                            if ([path hasPrefix:loaderPathPrefix]) {
-                                NSString *loaderPath = [machOFile.filename stringByDeletingLastPathComponent];
-                                path = [[path stringByReplacingOccurrencesOfString:loaderPathPrefix withString:loaderPath] stringByStandardizingPath];
-                            }
-                            [self machOFileWithName:path]; // Loads as a side effect
-                        }
-                        [self.searchPathState popSearchPaths];
-                    }
-                }
-            }
+            [self loadDependenciesOfMachOFile:machOFile];
         }
         @catch (NSException *exception) {
             CDLogError(@"Caught exception: %@", exception);
@@ -157,32 +148,151 @@ NSString *CDErrorKey_Exception    = @"CDErrorKey_Exception";
     return YES;
 }
 
-#pragma mark -
+#pragma mark - Loading dependencies
 
-- (void)processObjectiveCData;
+- (CDMachOFile *)machOFileWithFilename:(NSString *)filename;
 {
-    
-    for (CDMachOFile *machOFile in self.machOFiles) {
-        CDObjectiveCProcessor *processor = [[[machOFile processorClass] alloc] initWithMachOFile:machOFile];
-//        processor.shallow = _configuration.shallow;
-        [processor processStoppingEarly:NO];
-        [_objcProcessors addObject:processor];
+    @synchronized (_machOFilesByName) {
+        return _machOFilesByName[filename];
     }
 }
 
-// This visits everything segment processors, classes, categories.  It skips over modules.  Need something to visit modules so we can generate separate headers.
-- (void)recursivelyVisit:(CDVisitor *)visitor;
+- (void)registerMachOFile:(CDMachOFile *)machOFile;
 {
-    [visitor willBeginVisiting];
+    @synchronized (_machOFilesByName) {
+        _machOFilesByName[machOFile.filename] = machOFile;
+    }
+}
+
+// Loads everything machOFile depends on, a level at a time.  All of a level's dependencies are resolved first, then
+// opened and parsed concurrently.  Each image carries the run paths of the chain that led to it, which is what the
+// shared search path stack used to hold while loading depth first.
+- (void)loadDependenciesOfMachOFile:(CDMachOFile *)rootMachOFile;
+{
+    CDArch targetArch = self.targetArch;
+    CDFileLoadingMode loadingMode = _configuration.fileLoadingMode;
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
     
-    for (CDObjectiveCProcessor *processor in self.objcProcessors) {
-        [processor recursivelyVisit:visitor];
+    NSMutableDictionary<NSString *, NSArray<NSString *> *> *dependencyNamesByFilename = [NSMutableDictionary dictionary];
+    NSMutableSet<NSString *> *loadedNames = [NSMutableSet set];
+    NSMutableSet<NSString *> *failedNames = [NSMutableSet set];
+    
+    NSArray<CDMachOFile *> *level = @[ rootMachOFile ];
+    NSArray<NSArray<NSString *> *> *levelSearchPaths = @[ [(NSArray<NSString *> *)[self.searchPathState searchPaths] arrayByAddingObjectsFromArray:rootMachOFile.runPaths] ];
+    
+    while ([level count] > 0) {
+        // Resolving @rpath hits the file system, so do the whole level at once.
+        NSMutableArray<NSArray<NSString *> *> *resolvedNames = [NSMutableArray arrayWithCapacity:[level count]];
+        for (NSUInteger index = 0; index < [level count]; index++)
+            [resolvedNames addObject:@[]];
+        dispatch_apply([level count], queue, ^(size_t index) {
+            @try {
+                NSArray<NSString *> *names = [self dependencyNamesOfMachOFile:level[index] searchPaths:levelSearchPaths[index]];
+                @synchronized (resolvedNames) {
+                    resolvedNames[index] = names;
+                }
+            }
+            @catch (NSException *exception) {
+                CDLogWarning(@"Warning: Caught exception resolving dependencies of %@: %@", level[index].filename, exception);
+            }
+        });
+        
+        // Pick out the ones we haven't seen yet, in load command order.
+        NSMutableArray<NSString *> *pendingNames = [NSMutableArray array];
+        NSMutableArray<NSArray<NSString *> *> *pendingSearchPaths = [NSMutableArray array];
+        NSMutableSet<NSString *> *pendingNameSet = [NSMutableSet set];
+        for (NSUInteger index = 0; index < [level count]; index++) {
+            dependencyNamesByFilename[level[index].filename] = resolvedNames[index];
+            for (NSString *name in resolvedNames[index]) {
+                if ([self machOFileWithFilename:name] != nil || [pendingNameSet containsObject:name] || [failedNames containsObject:name])
+                    continue;
+                [pendingNameSet addObject:name];
+                [pendingNames addObject:name];
+                [pendingSearchPaths addObject:levelSearchPaths[index]];
+            }
+        }
+        
+        NSMutableArray *machOFiles = [NSMutableArray arrayWithCapacity:[pendingNames count]];
+        for (NSUInteger index = 0; index < [pendingNames count]; index++)
+            [machOFiles addObject:[NSNull null]];
+        // A dependency that can't be loaded is only a warning, like it was when each one was loaded on its own.
+        dispatch_apply([pendingNames count], queue, ^(size_t index) {
+            @try {
+                CDFile *file = [CDFile fileWithContentsOfFile:pendingNames[index] searchPathState:self.searchPathState loadingMode:loadingMode];
+                CDMachOFile *machOFile = [file machOFileWithArch:targetArch];
+                if (machOFile != nil) {
+                    @synchronized (machOFiles) {
+                        machOFiles[index] = machOFile;
+                    }
+                }
+            }
+            @catch (NSException *exception) {
+                CDLogWarning(@"Warning: Caught exception loading %@: %@", pendingNames[index], exception);
+            }
+        });
+        
+        NSMutableArray<CDMachOFile *> *nextLevel = [NSMutableArray array];
+        NSMutableArray<NSArray<NSString *> *> *nextSearchPaths = [NSMutableArray array];
+        for (NSUInteger index = 0; index < [pendingNames count]; index++) {
+            if (machOFiles[index] == [NSNull null]) {
+                CDLogWarning(@"Warning: Failed to load: %@", pendingNames[index]);
+                [failedNames addObject:pendingNames[index]];
+                continue;
+            }
+            
+            CDMachOFile *machOFile = machOFiles[index];
+            assert([machOFile filename] != nil);
+            [self registerMachOFile:machOFile];
+            [loadedNames addObject:machOFile.filename];
+            [nextLevel addObject:machOFile];
+            [nextSearchPaths addObject:[pendingSearchPaths[index] arrayByAddingObjectsFromArray:machOFile.runPaths]];
+        }
+        
+        level = nextLevel;
+        levelSearchPaths = nextSearchPaths;
     }
     
-    [visitor didEndVisiting];
+    // Keep the images in the order the depth first loader used to add them.
+    [self appendMachOFile:rootMachOFile dependencyNamesByFilename:dependencyNamesByFilename loadedNames:loadedNames];
+    CDLogVerbose(@"%@ %@", rootMachOFile.importBaseName, [self.searchPathState statisticsDescription]);
+}
+
+- (void)appendMachOFile:(CDMachOFile *)machOFile dependencyNamesByFilename:(NSDictionary<NSString *, NSArray<NSString *> *> *)dependencyNamesByFilename loadedNames:(NSMutableSet<NSString *> *)loadedNames;
+{
+    for (NSString *name in dependencyNamesByFilename[machOFile.filename]) {
+        if ([loadedNames containsObject:name] == NO)
+            continue;
+        
+        [loadedNames removeObject:name];
+        CDMachOFile *dependency = [self machOFileWithFilename:name];
+        [_machOFiles addObject:dependency];
+        [self appendMachOFile:dependency dependencyNamesByFilename:dependencyNamesByFilename loadedNames:loadedNames];
+    }
 }
 
-- (CDMachOFile *)machOFileWithName:(NSString *)name;
+- (NSArray<NSString *> *)dependencyNamesOfMachOFile:(CDMachOFile *)machOFile searchPaths:(NSArray<NSString *> *)searchPaths;
+{
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    for (CDLoadCommand *loadCommand in [machOFile loadCommands]) {
+        if ([loadCommand isKindOfClass:[CDLCDylib class]]) {
+            CDLCDylib *dylibCommand = (CDLCDylib *)loadCommand;
+            if ([dylibCommand cmd] == LC_LOAD_DYLIB) {
+                NSString *loaderPathPrefix = @"@loader_path";
+                
+                NSString *path = [dylibCommand path];
+                if ([path hasPrefix:loaderPathPrefix]) {
+                    NSString *loaderPath = [machOFile.filename stringByDeletingLastPathComponent];
+                    path = [[path stringByReplacingOccurrencesOfString:loaderPathPrefix withString:loaderPath] stringByStandardizingPath];
+                }
+                [names addObject:[self adjustedNameForName:path searchPaths:searchPaths]];
+            }
+        }
+    }
+    
+    return names;
+}
+
+- (NSString *)adjustedNameForName:(NSString *)name searchPaths:(NSArray<NSString *> *)searchPaths;
 {
     NSString *adjustedName = nil;
     NSString *executablePathPrefix = @"@executable_path";
@@ -191,16 +301,8 @@ NSString *CDErrorKey_Exception    = @"CDErrorKey_Exception";
     if ([name hasPrefix:executablePathPrefix]) {
         adjustedName = [name stringByReplacingOccurrencesOfString:executablePathPrefix withString:self.searchPathState.executablePath];
     } else if ([name hasPrefix:rpathPrefix]) {
-        //CDLog(@"Searching for %@ through run paths: %@", name, [searchPathState searchPaths]);
-        for (NSString *searchPath in [self.searchPathState searchPaths]) {
-            NSString *str = [name stringByReplacingOccurrencesOfString:rpathPrefix withString:searchPath];
-            //CDLog(@"trying %@", str);
-            if ([[NSFileManager defaultManager] fileExistsAtPath:str]) {
-                adjustedName = str;
-                //CDLog(@"Found it!");
-                break;
-            }
-        }
+        //CDLog(@"Searching for %@ through run paths: %@", name, searchPaths);
+        adjustedName = [self.searchPathState resolvedPathForRunPathName:name searchPaths:searchPaths];
         if (adjustedName == nil) {
             adjustedName = name;
             //CDLog(@"Did not find it.");
@@ -211,20 +313,77 @@ NSString *CDErrorKey_Exception    = @"CDErrorKey_Exception";
         adjustedName = name;
     }
     
-    CDMachOFile *machOFile = _machOFilesByName[adjustedName];
-    if (machOFile == nil) {
-        CDFile *file = [CDFile fileWithContentsOfFile:adjustedName searchPathState:self.searchPathState];
-        
-        if (file == nil || [self loadFile:file error:NULL] == NO)
-            CDLogWarning(@"Warning: Failed to load: %@", adjustedName);
-        
-        machOFile = _machOFilesByName[adjustedName];
-        if (machOFile == nil) {
-            CDLogWarning(@"Warning: Couldn't load MachOFile with ID: %@, adjustedID: %@", name, adjustedName);
+    return adjustedName;
+}
+
+#pragma mark -
+
+// Runs block once per index, on all cores when images are processed concurrently.  dispatch_apply() never runs
+// more of them at once than there are CPUs.
+- (void)forEachImageIndex:(NSUInteger)count perform:(void (^)(size_t index))block;
+{
+    if (_configuration.shouldProcessImagesConcurrently && count > 1) {
+        dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), block);
+    } else {
+        for (NSUInteger index = 0; index < count; index++)
+            block(index);
+    }
+}
+
+- (void)processObjectiveCData;
+{
+    NSArray<CDMachOFile *> *machOFiles = [self.machOFiles copy];
+    NSMutableArray *processors = [NSMutableArray arrayWithCapacity:[machOFiles count]];
+    for (NSUInteger index = 0; index < [machOFiles count]; index++)
+        [processors addObject:[NSNull null]];
+
+    CDObjectiveCCache *cache = nil;
+    if (_configuration.objectiveCCacheDirectory != nil)
+        cache = [[CDObjectiveCCache alloc] initWithDirectory:_configuration.objectiveCCacheDirectory configuration:_configuration];
+    _objectiveCCache = cache;
+    
+    [self forEachImageIndex:[machOFiles count] perform:^(size_t index) {
+        CDMachOFile *machOFile = machOFiles[index];
+        CDObjectiveCProcessor *processor = [[[machOFile processorClass] alloc] initWithMachOFile:machOFile];
+//        processor.shallow = _configuration.shallow;
+        processor.loadsInParallel = self->_configuration.shouldLoadObjectiveCDataInParallel;
+        if (cache == nil || [cache loadProcessor:processor] == NO) {
+            [processor processStoppingEarly:NO];
+            [cache storeProcessor:processor];
+        }
+        CDLogVerbose(@"%@ %@", machOFile.importBaseName, [machOFile.stringPool statisticsDescription]);
+        @synchronized (processors) {
+            processors[index] = processor;
+        }
+    }];
+    
+    // Keep the processors in load order, however they finished.
+    [_objcProcessors addObjectsFromArray:processors];
+
+    if (cache != nil)
+        CDLogVerbose(@"Objective-C %@", [cache statisticsDescription]);
+
+    // The architectures of a fat file share one mapping, so report each mapping once.
+    NSHashTable<CDMappedData *> *reportedData = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    for (CDMachOFile *machOFile in machOFiles) {
+        CDMappedData *mappedData = machOFile.mappedData;
+        if (mappedData != nil && [reportedData containsObject:mappedData] == NO) {
+            [reportedData addObject:mappedData];
+            CDLogVerbose(@"%@ %@", machOFile.importBaseName, [mappedData statisticsDescription]);
         }
     }
+}
+
+// This visits everything segment processors, classes, categories.  It skips over modules.  Need something to visit modules so we can generate separate headers.
+- (void)recursivelyVisit:(CDVisitor *)visitor;
+{
+    [visitor willBeginVisiting];
+    
+    for (CDObjectiveCProcessor *processor in self.objcProcessors) {
+        [processor recursivelyVisit:visitor];
+    }
     
-    return machOFile;
+    [visitor didEndVisiting];
 }
 
 - (void)appendHeaderToString:(NSMutableString *)resultString;
@@ -248,7 +407,15 @@ NSString *CDErrorKey_Exception    = @"CDErrorKey_Exception";
 
 - (void)registerTypes;
 {
-    for (CDObjectiveCProcessor *processor in self.objcProcessors) {
+    // Parsing is the expensive part, and each distinct encoding is only parsed once across all the images.  Registering
+    // the results with the type controller is cheap after that, and is done in load order so the structure tables come out the same every time.
+    NSArray<CDObjectiveCProcessor *> *processors = [self.objcProcessors copy];
+    [self forEachImageIndex:[processors count] perform:^(size_t index) {
+        [processors[index] parseTypes];
+    }];
+    CDLogVerbose(@"%@", [[CDTypeParseCache sharedCache] statisticsDescription]);
+    
+    for (CDObjectiveCProcessor *processor in processors) {
         [processor registerTypesWithObject:self.typeController phase:0];
     }
     [self.typeController endPhase:0];
@@ -8,6 +8,7 @@
 #import <Foundation/Foundation.h>
 #import <ClassDump/CDOCPropertyAttribute.h>
 #import <ClassDump/CDFatArch.h>
+#import <ClassDump/CDMappedData.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -42,6 +43,19 @@ NS_ASSUME_NONNULL_BEGIN
 /// replace @c retain to @c strong
 @property BOOL shouldUseStrongPropertyAttribute;
 @property BOOL shouldGenerateEmptyImplementationFile;
+/// Only write output files whose contents changed, and remove files left over from a previous run that are no longer
+/// generated, defaults to NO.  Uses a manifest in the output directory.
+@property BOOL shouldWriteOnlyChangedFiles;
+/// How input files are brought into memory, defaults to mapping regular files and streaming everything else.
+@property CDFileLoadingMode fileLoadingMode;
+/// Load the Objective-C metadata of large images on all cores, defaults to YES.  Output is the same either way.
+@property BOOL shouldLoadObjectiveCDataInParallel;
+/// Process and parse the types of each loaded image concurrently, defaults to YES.  Output is the same either way.
+@property BOOL shouldProcessImagesConcurrently;
+/// Merge independent structures and unions of the same depth in parallel, defaults to YES.  Output is the same either way.
+@property BOOL shouldMergeStructuresInParallel;
+/// Directory for the on-disk cache of loaded Objective-C metadata, keyed by each image's UUID.  Defaults to nil, no cache.
+@property (copy, nullable) NSString *objectiveCCacheDirectory;
 
 //@property (copy, nullable) NSRegularExpression *regularExpression;
 @property (copy) NSArray<CDOCPropertyAttributeType> *sortedPropertyAttributeTypes;
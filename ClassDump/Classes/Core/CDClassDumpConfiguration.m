@@ -27,6 +27,9 @@
 - (instancetype)init {
     self = [super init];
     if (self) {
+        self.shouldLoadObjectiveCDataInParallel = YES;
+        self.shouldProcessImagesConcurrently = YES;
+        self.shouldMergeStructuresInParallel = YES;
         [self commonInit];
     }
     return self;
@@ -51,6 +54,21 @@
         self.shouldUseNSUIntegerTypedef = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldUseNSUIntegerTypedef))];
         self.shouldUseStrongPropertyAttribute = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldUseStrongPropertyAttribute))];
         self.shouldGenerateEmptyImplementationFile = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldGenerateEmptyImplementationFile))];
+        self.shouldWriteOnlyChangedFiles = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldWriteOnlyChangedFiles))];
+        self.fileLoadingMode = [coder decodeIntegerForKey:NSStringFromSelector(@selector(fileLoadingMode))];
+        if ([coder containsValueForKey:NSStringFromSelector(@selector(shouldLoadObjectiveCDataInParallel))])
+            self.shouldLoadObjectiveCDataInParallel = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldLoadObjectiveCDataInParallel))];
+        else
+            self.shouldLoadObjectiveCDataInParallel = YES;
+        if ([coder containsValueForKey:NSStringFromSelector(@selector(shouldProcessImagesConcurrently))])
+            self.shouldProcessImagesConcurrently = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldProcessImagesConcurrently))];
+        else
+            self.shouldProcessImagesConcurrently = YES;
+        if ([coder containsValueForKey:NSStringFromSelector(@selector(shouldMergeStructuresInParallel))])
+            self.shouldMergeStructuresInParallel = [coder decodeBoolForKey:NSStringFromSelector(@selector(shouldMergeStructuresInParallel))];
+        else
+            self.shouldMergeStructuresInParallel = YES;
+        self.objectiveCCacheDirectory = [coder decodeObjectOfClass:[NSString class] forKey:NSStringFromSelector(@selector(objectiveCCacheDirectory))];
         self.sortedPropertyAttributeTypes = [coder decodeObjectOfClasses:[NSSet setWithArray:@[[NSArray class], [NSString class]]] forKey:NSStringFromSelector(@selector(sortedPropertyAttributeTypes))];
         self.preferredStructureFilename = [coder decodeObjectOfClass:[NSString class] forKey:NSStringFromSelector(@selector(preferredStructureFilename))];
         [self commonInit];
@@ -76,6 +94,12 @@
     [coder encodeBool:self.shouldUseNSUIntegerTypedef forKey:NSStringFromSelector(@selector(shouldUseNSUIntegerTypedef))];
     [coder encodeBool:self.shouldUseStrongPropertyAttribute forKey:NSStringFromSelector(@selector(shouldUseStrongPropertyAttribute))];
     [coder encodeBool:self.shouldGenerateEmptyImplementationFile forKey:NSStringFromSelector(@selector(shouldGenerateEmptyImplementationFile))];
+    [coder encodeBool:self.shouldWriteOnlyChangedFiles forKey:NSStringFromSelector(@selector(shouldWriteOnlyChangedFiles))];
+    [coder encodeInteger:self.fileLoadingMode forKey:NSStringFromSelector(@selector(fileLoadingMode))];
+    [coder encodeBool:self.shouldLoadObjectiveCDataInParallel forKey:NSStringFromSelector(@selector(shouldLoadObjectiveCDataInParallel))];
+    [coder encodeBool:self.shouldProcessImagesConcurrently forKey:NSStringFromSelector(@selector(shouldProcessImagesConcurrently))];
+    [coder encodeBool:self.shouldMergeStructuresInParallel forKey:NSStringFromSelector(@selector(shouldMergeStructuresInParallel))];
+    [coder encodeObject:self.objectiveCCacheDirectory forKey:NSStringFromSelector(@selector(objectiveCCacheDirectory))];
     [coder encodeObject:self.sortedPropertyAttributeTypes forKey:NSStringFromSelector(@selector(sortedPropertyAttributeTypes))];
     [coder encodeObject:self.preferredStructureFilename forKey:NSStringFromSelector(@selector(preferredStructureFilename))];
 }
@@ -146,6 +170,12 @@
 //    self.regularExpression = configuration.regularExpression;
     self.sortedPropertyAttributeTypes = configuration.sortedPropertyAttributeTypes;
     self.shouldGenerateEmptyImplementationFile = configuration.shouldGenerateEmptyImplementationFile;
+    self.shouldWriteOnlyChangedFiles = configuration.shouldWriteOnlyChangedFiles;
+    self.fileLoadingMode = configuration.fileLoadingMode;
+    self.shouldLoadObjectiveCDataInParallel = configuration.shouldLoadObjectiveCDataInParallel;
+    self.shouldProcessImagesConcurrently = configuration.shouldProcessImagesConcurrently;
+    self.shouldMergeStructuresInParallel = configuration.shouldMergeStructuresInParallel;
+    self.objectiveCCacheDirectory = configuration.objectiveCCacheDirectory;
     self.preferredStructureFilename = configuration.preferredStructureFilename;
     self.protocolFilenameFormatter = configuration.protocolFilenameFormatter;
     self.categoryFilenameFormatter = configuration.categoryFilenameFormatter;
@@ -116,8 +116,8 @@
     NSUInteger savedOffset = self.offset;
     uint64_t val = 0;
     switch (_ptrSize) {
-        case sizeof(uint32_t): val = [self readInt32];
-        case sizeof(uint64_t): val = [self readInt64];
+        case sizeof(uint32_t): val = [self readInt32]; break;
+        case sizeof(uint64_t): val = [self readInt64]; break;
     }
     //uint32_t val = [self readInt32];
     self.offset = savedOffset;
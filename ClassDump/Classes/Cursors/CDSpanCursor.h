@@ -0,0 +1,74 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+#include <libkern/OSByteOrder.h>
+
+@class CDMachOFile, CDSection;
+
+typedef NS_ENUM(NSInteger, CDSpanStatus) {
+    CDSpanStatusOK = 0,
+    CDSpanStatusNullAddress, // Asked to seek to address 0
+    CDSpanStatusOutOfBounds, // The span runs past the end of the data
+    CDSpanStatusUnmapped,    // A chained fixup address that doesn't land in any segment, even after rebasing
+};
+
+// A plain struct cursor for the hot ObjC2 paths, meant to live on the stack.  A span is bounds checked once when
+// it's set up with one of the seek/extend functions, the reads inside it aren't checked again.  Reading past the
+// validated span is a programming error and is only caught by the assertions in debug builds.
+typedef struct {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+    NSUInteger spanEnd;
+    NSUInteger ptrSize;
+    BOOL isBigEndian;
+} CDSpanCursor;
+
+// Over the whole file, with an empty span.
+extern void CDSpanCursorInit(CDSpanCursor *cursor, CDMachOFile *machOFile);
+// Over the data of a section, with the span covering all of it.  A nil section gives an empty cursor.
+extern void CDSpanCursorInitWithSection(CDSpanCursor *cursor, CDMachOFile *machOFile, CDSection *section);
+
+extern CDSpanStatus CDSpanCursorSeekOffset(CDSpanCursor *cursor, NSUInteger offset, NSUInteger length);
+// Addresses are translated like -[CDMachOFileDataCursor setAddress:] does it, except that an address that can't be
+// found fails with CDSpanStatusUnmapped instead of exiting.
+extern CDSpanStatus CDSpanCursorSeekAddress(CDSpanCursor *cursor, CDMachOFile *machOFile, uint64_t address, NSUInteger length);
+// Validates count elements from the current offset, guarding against count * elementSize overflowing.
+extern CDSpanStatus CDSpanCursorExtend(CDSpanCursor *cursor, uint64_t count, NSUInteger elementSize);
+
+extern NSString *CDSpanStatusDescription(CDSpanStatus status);
+
+static inline NSUInteger CDSpanCursorRemaining(const CDSpanCursor *cursor)
+{
+    return cursor->spanEnd - cursor->offset;
+}
+
+static inline void CDSpanCursorSkip(CDSpanCursor *cursor, NSUInteger length)
+{
+    NSCAssert(length <= cursor->spanEnd - cursor->offset, @"Skip outside of the validated span");
+    cursor->offset += length;
+}
+
+static inline uint32_t CDSpanCursorReadInt32(CDSpanCursor *cursor)
+{
+    NSCAssert(sizeof(uint32_t) <= cursor->spanEnd - cursor->offset, @"Read outside of the validated span");
+    uint32_t value = cursor->isBigEndian ? OSReadBigInt32(cursor->bytes, cursor->offset) : OSReadLittleInt32(cursor->bytes, cursor->offset);
+    cursor->offset += sizeof(uint32_t);
+    return value;
+}
+
+static inline uint64_t CDSpanCursorReadInt64(CDSpanCursor *cursor)
+{
+    NSCAssert(sizeof(uint64_t) <= cursor->spanEnd - cursor->offset, @"Read outside of the validated span");
+    uint64_t value = cursor->isBigEndian ? OSReadBigInt64(cursor->bytes, cursor->offset) : OSReadLittleInt64(cursor->bytes, cursor->offset);
+    cursor->offset += sizeof(uint64_t);
+    return value;
+}
+
+static inline uint64_t CDSpanCursorReadPtr(CDSpanCursor *cursor)
+{
+    return cursor->ptrSize == sizeof(uint64_t) ? CDSpanCursorReadInt64(cursor) : CDSpanCursorReadInt32(cursor);
+}
@@ -0,0 +1,88 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDSpanCursor.h>
+
+#import <ClassDump/CDMachOFile.h>
+#import <ClassDump/CDAddressIndex.h>
+#import <ClassDump/CDLCChainedFixups.h>
+#import <ClassDump/CDSection.h>
+
+void CDSpanCursorInit(CDSpanCursor *cursor, CDMachOFile *machOFile)
+{
+    NSData *data = machOFile.data;
+    cursor->bytes       = (const uint8_t *)[data bytes];
+    cursor->length      = [data length];
+    cursor->offset      = 0;
+    cursor->spanEnd     = 0;
+    cursor->ptrSize     = machOFile.ptrSize;
+    cursor->isBigEndian = machOFile.byteOrder == CDByteOrder_BigEndian;
+}
+
+void CDSpanCursorInitWithSection(CDSpanCursor *cursor, CDMachOFile *machOFile, CDSection *section)
+{
+    NSData *data = [section data];
+    cursor->bytes       = (const uint8_t *)[data bytes];
+    cursor->length      = [data length];
+    cursor->offset      = 0;
+    cursor->spanEnd     = cursor->length;
+    cursor->ptrSize     = machOFile.ptrSize;
+    cursor->isBigEndian = machOFile.byteOrder == CDByteOrder_BigEndian;
+}
+
+CDSpanStatus CDSpanCursorSeekOffset(CDSpanCursor *cursor, NSUInteger offset, NSUInteger length)
+{
+    if (offset > cursor->length || length > cursor->length - offset)
+        return CDSpanStatusOutOfBounds;
+
+    cursor->offset  = offset;
+    cursor->spanEnd = offset + length;
+    return CDSpanStatusOK;
+}
+
+CDSpanStatus CDSpanCursorSeekAddress(CDSpanCursor *cursor, CDMachOFile *machOFile, uint64_t address, NSUInteger length)
+{
+    if (address == 0)
+        return CDSpanStatusNullAddress;
+
+    // The same lookup as -[CDMachOFile dataOffsetForAddress:], which exits when a chained fixup address can't be found.
+    NSUInteger offset = [machOFile.addressIndex fileOffsetForAddress:address];
+    if (offset == NSNotFound && machOFile.chainedFixups != nil) {
+        uint64_t based = [machOFile.chainedFixups rebaseTargetFromAddress:address];
+        if (based == 0)
+            based = [machOFile fixupBasedAddress:address];
+        offset = [machOFile.addressIndex fileOffsetForAddress:based];
+        if (offset == NSNotFound)
+            return CDSpanStatusUnmapped;
+    }
+
+    // Addresses that don't map anywhere are tried as file offsets, as -[CDMachOFileDataCursor setAddress:] does.
+    if (offset == NSNotFound || offset == 0)
+        offset = address;
+
+    return CDSpanCursorSeekOffset(cursor, offset, length);
+}
+
+CDSpanStatus CDSpanCursorExtend(CDSpanCursor *cursor, uint64_t count, NSUInteger elementSize)
+{
+    NSUInteger available = cursor->length - cursor->offset;
+    if (elementSize != 0 && count > available / elementSize)
+        return CDSpanStatusOutOfBounds;
+
+    cursor->spanEnd = cursor->offset + (NSUInteger)count * elementSize;
+    return CDSpanStatusOK;
+}
+
+NSString *CDSpanStatusDescription(CDSpanStatus status)
+{
+    switch (status) {
+        case CDSpanStatusOK:          return @"ok";
+        case CDSpanStatusNullAddress: return @"null address";
+        case CDSpanStatusOutOfBounds: return @"out of bounds";
+        case CDSpanStatusUnmapped:    return @"unmapped address";
+    }
+
+    return @"unknown";
+}
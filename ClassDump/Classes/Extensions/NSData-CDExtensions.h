@@ -9,5 +9,7 @@
 
 - (NSString *)hexString;
 - (NSData *)SHA1Digest;
+// 64-bit FNV-1a of the bytes, the same hash -[NSString FNV1aHash] uses.
+- (uint64_t)FNV1aHash;
 
 @end
@@ -30,4 +30,16 @@
     return [NSData dataWithBytes:digest length:CC_SHA1_DIGEST_LENGTH];
 }
 
+- (uint64_t)FNV1aHash;
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const uint8_t *ptr = [self bytes];
+    for (NSUInteger index = 0; index < [self length]; index++) {
+        hash ^= *ptr++;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
 @end
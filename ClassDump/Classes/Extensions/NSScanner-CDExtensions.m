@@ -15,9 +15,11 @@
 + (NSCharacterSet *)cdOtherCharacterSet;
 {
     static NSCharacterSet *otherCharacterSet = nil;
+    static dispatch_once_t onceToken;
 
-    if (otherCharacterSet == nil)
+    dispatch_once(&onceToken, ^{
         otherCharacterSet = [NSCharacterSet characterSetWithCharactersInString:@"$_:*"];
+    });
 
     return otherCharacterSet;
 }
@@ -25,12 +27,13 @@
 + (NSCharacterSet *)cdIdentifierStartCharacterSet;
 {
     static NSCharacterSet *identifierStartCharacterSet = nil;
+    static dispatch_once_t onceToken;
 
-    if (identifierStartCharacterSet == nil) {
+    dispatch_once(&onceToken, ^{
         NSMutableCharacterSet *set = [[NSCharacterSet letterCharacterSet] mutableCopy];
         [set formUnionWithCharacterSet:[NSScanner cdOtherCharacterSet]];
         identifierStartCharacterSet = [set copy];
-    }
+    });
 
     return identifierStartCharacterSet;
 }
@@ -38,12 +41,13 @@
 + (NSCharacterSet *)cdIdentifierCharacterSet;
 {
     static NSCharacterSet *identifierCharacterSet = nil;
+    static dispatch_once_t onceToken;
 
-    if (identifierCharacterSet == nil) {
+    dispatch_once(&onceToken, ^{
         NSMutableCharacterSet *set = [[NSCharacterSet alphanumericCharacterSet] mutableCopy];
         [set formUnionWithCharacterSet:[NSScanner cdOtherCharacterSet]];
         identifierCharacterSet = [set copy];
-    }
+    });
 
     return identifierCharacterSet;
 }
@@ -51,9 +55,11 @@
 + (NSCharacterSet *)cdTemplateTypeCharacterSet;
 {
     static NSCharacterSet *templateTypeCharacterSet = nil;
+    static dispatch_once_t onceToken;
 
-    if (templateTypeCharacterSet == nil)
+    dispatch_once(&onceToken, ^{
         templateTypeCharacterSet = [[NSCharacterSet characterSetWithCharactersInString:@"<,>"] invertedSet];
+    });
 
     return templateTypeCharacterSet;
 }
@@ -28,6 +28,9 @@
 - (NSString *)executablePathForFilename;
 
 - (NSString *)SHA1DigestString;
+// 64-bit FNV-1a of the UTF-8 bytes, after canonical decomposition.  Not cryptographic, but fast and stable between runs.
+- (uint64_t)FNV1aHash;
+- (NSString *)FNV1aDigestString;
 
 - (BOOL)hasUnderscoreCapitalPrefix;
 - (NSString *)capitalizeFirstCharacter;
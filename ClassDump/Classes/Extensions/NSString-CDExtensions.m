@@ -113,6 +113,36 @@
     return [[[[self decomposedStringWithCanonicalMapping] dataUsingEncoding:NSUTF8StringEncoding] SHA1Digest] hexString];
 }
 
+- (uint64_t)FNV1aHash;
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const uint8_t *ptr = (const uint8_t *)[self UTF8String];
+    if (ptr == NULL)
+        return hash;
+
+    BOOL isASCII = YES;
+    for (; *ptr != 0; ptr++) {
+        hash ^= *ptr;
+        hash *= 0x100000001b3ULL;
+        if (*ptr >= 0x80)
+            isASCII = NO;
+    }
+
+    // ASCII is already decomposed, which is nearly every type string.  Only pay for the decomposition otherwise.
+    if (isASCII == NO) {
+        NSString *decomposed = [self decomposedStringWithCanonicalMapping];
+        if ([decomposed isEqualToString:self] == NO)
+            return [decomposed FNV1aHash];
+    }
+
+    return hash;
+}
+
+- (NSString *)FNV1aDigestString;
+{
+    return [NSString stringWithFormat:@"%016llx", self.FNV1aHash];
+}
+
 - (BOOL)hasUnderscoreCapitalPrefix;
 {
     if ([self length] < 2)
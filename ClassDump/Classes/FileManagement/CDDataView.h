@@ -0,0 +1,21 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// An immutable view of a byte range inside another NSData.  No bytes are copied; the backing data is retained
+// for as long as the view is alive, so views of the mapped file can be handed out freely.
+@interface CDDataView : NSData
+
+- (instancetype)initWithData:(NSData *)data range:(NSRange)range;
+
+@property (readonly) NSData *backingData;
+@property (readonly) NSRange range; // Relative to backingData
+
+@end
+
+NS_ASSUME_NONNULL_END
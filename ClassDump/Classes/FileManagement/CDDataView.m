@@ -0,0 +1,64 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDDataView.h>
+
+@implementation CDDataView
+{
+    NSData *_backingData;
+    NSRange _range;
+    const uint8_t *_bytes;
+}
+
+- (instancetype)initWithData:(NSData *)data range:(NSRange)range;
+{
+    NSParameterAssert(NSMaxRange(range) <= [data length]);
+
+    if ((self = [super init])) {
+        // Views of views point straight at the outermost data, so we never build chains.
+        if ([data isKindOfClass:[CDDataView class]]) {
+            CDDataView *parent = (CDDataView *)data;
+            range.location += parent.range.location;
+            data = parent.backingData;
+        }
+
+        _backingData = data;
+        _range       = range;
+        _bytes       = (const uint8_t *)[data bytes] + range.location;
+    }
+
+    return self;
+}
+
+#pragma mark - NSData primitives
+
+- (const void *)bytes;
+{
+    return _bytes;
+}
+
+- (NSUInteger)length;
+{
+    return _range.length;
+}
+
+#pragma mark -
+
+- (NSData *)subdataWithRange:(NSRange)range;
+{
+    if (NSMaxRange(range) > _range.length) {
+        [NSException raise:NSRangeException format:@"Range %@ exceeds view length %lu", NSStringFromRange(range), _range.length];
+    }
+
+    return [[CDDataView alloc] initWithData:self range:range];
+}
+
+- (id)copyWithZone:(NSZone *)zone;
+{
+    // Immutable, and the backing data is immutable too.
+    return self;
+}
+
+@end
@@ -7,6 +7,7 @@
 
 #include <mach-o/fat.h>
 #import <ClassDump/CDDataCursor.h>
+#import <ClassDump/CDDataView.h>
 #import <ClassDump/CDFatFile.h>
 #import <ClassDump/CDMachOFile.h>
 #import <ClassDump/ClassDumpUtils.h>
@@ -99,7 +100,7 @@
     }
     
     if (_machOFile == nil) {
-        NSData *data = [NSData dataWithBytesNoCopy:((uint8_t *)[self.fatFile.data bytes] + self.offset) length:self.size freeWhenDone:NO];
+        NSData *data = [[CDDataView alloc] initWithData:self.fatFile.data range:NSMakeRange(self.offset, self.size)];
         _machOFile = [[CDMachOFile alloc] initWithData:data filename:self.fatFile.filename searchPathState:self.fatFile.searchPathState];
     }
 
@@ -5,6 +5,7 @@
 
 #import <Foundation/Foundation.h>
 #include <mach/machine.h> // For cpu_type_t, cpu_subtype_t
+#import <ClassDump/CDMappedData.h>
 
 typedef struct __attribute__((objc_boxable)) {
     cpu_type_t cputype;
@@ -23,6 +24,7 @@ BOOL CDArchUses64BitLibraries(CDArch arch);
 
 // Returns CDFatFile or CDMachOFile
 + (id)fileWithContentsOfFile:(NSString *)filename searchPathState:(CDSearchPathState *)searchPathState;
++ (id)fileWithContentsOfFile:(NSString *)filename searchPathState:(CDSearchPathState *)searchPathState loadingMode:(CDFileLoadingMode)loadingMode;
 
 - (instancetype)initWithData:(NSData *)data filename:(NSString *)filename searchPathState:(CDSearchPathState *)searchPathState;
 
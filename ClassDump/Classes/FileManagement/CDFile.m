@@ -123,10 +123,18 @@ BOOL CDArchUses64BitLibraries(CDArch arch)
 // Returns CDFatFile or CDMachOFile
 + (id)fileWithContentsOfFile:(NSString *)filename searchPathState:(CDSearchPathState *)searchPathState;
 {
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated"
-    NSData *data = [NSData dataWithContentsOfMappedFile:filename];
-#pragma clang diagnostic pop
+    return [self fileWithContentsOfFile:filename searchPathState:searchPathState loadingMode:CDFileLoadingModeAutomatic];
+}
+
++ (id)fileWithContentsOfFile:(NSString *)filename searchPathState:(CDSearchPathState *)searchPathState loadingMode:(CDFileLoadingMode)loadingMode;
+{
+    NSError *error = nil;
+    NSData *data = [CDMappedData dataWithContentsOfFile:filename loadingMode:loadingMode error:&error];
+    if (data == nil) {
+        CDLogVerbose(@"Couldn't load %@: %@", filename, [error localizedFailureReason]);
+        return nil;
+    }
+    
     CDFatFile *fatFile = [[CDFatFile alloc] initWithData:data filename:filename searchPathState:searchPathState];
     if (fatFile != nil)
         return fatFile;
@@ -13,8 +13,8 @@ typedef enum : NSUInteger {
     CDByteOrder_BigEndian = 1,
 } CDByteOrder;
 
-@class CDLCSegment;
-@class CDLCBuildVersion, CDLCDyldInfo, CDLCDylib, CDMachOFile, CDLCSymbolTable, CDLCDynamicSymbolTable, CDLCVersionMinimum, CDLCSourceVersion, CDLCChainedFixups, CDLCExportTRIEData, CDLoadCommand;
+@class CDLCSegment, CDAddressIndex, CDStringPool;
+@class CDLCBuildVersion, CDLCDyldInfo, CDLCDylib, CDMachOFile, CDLCSymbolTable, CDLCDynamicSymbolTable, CDLCVersionMinimum, CDLCSourceVersion, CDLCChainedFixups, CDLCExportTRIEData, CDLCFunctionStarts, CDLoadCommand;
 
 @interface CDMachOFile : CDFile
 
@@ -42,6 +42,7 @@ typedef enum : NSUInteger {
 @property (strong, readonly) CDLCDyldInfo *dyldInfo;
 @property (strong, readonly) CDLCExportTRIEData *exportsTrie;
 @property (strong, readonly) CDLCChainedFixups *chainedFixups;
+@property (strong, readonly) CDLCFunctionStarts *functionStarts;
 @property (strong, readonly) CDLCDylib *dylibIdentifier;
 @property (strong, readonly) CDLCVersionMinimum *minVersionMacOSX;
 @property (strong, readonly) CDLCVersionMinimum *minVersionIOS;
@@ -58,13 +59,23 @@ typedef enum : NSUInteger {
 - (CDLCSegment *)dataConstSegment;
 - (CDLCSegment *)segmentWithName:(NSString *)segmentName;
 - (CDLCSegment *)segmentContainingAddress:(NSUInteger)address;
+@property (readonly) CDAddressIndex *addressIndex;
 - (NSString *)stringAtAddress:(NSUInteger)address;
+@property (readonly) CDStringPool *stringPool;
 
 - (NSUInteger)dataOffsetForAddress:(NSUInteger)address;
 
 - (const void *)bytes;
 - (const void *)bytesAtOffset:(NSUInteger)offset;
 
+// Returns a zero-copy view of the file data, clamped to the end of the file.
+- (NSData *)dataViewAtOffset:(NSUInteger)offset length:(NSUInteger)length;
+
+// The backing store of this file (or of the fat file containing it), whether it was mapped or streamed, see -isMapped.
+// nil if the file was created from other data.
+@property (readonly) CDMappedData *mappedData;
+- (void)adviseAccess:(CDMappedDataAccess)access offset:(NSUInteger)offset length:(NSUInteger)length;
+
 @property (readonly) NSString *importBaseName;
 
 @property (readonly) BOOL isEncrypted;
@@ -10,6 +10,9 @@
 #include <mach-o/fat.h>
 
 #import <ClassDump/CDMachOFileDataCursor.h>
+#import <ClassDump/CDDataView.h>
+#import <ClassDump/CDAddressIndex.h>
+#import <ClassDump/CDStringPool.h>
 #import <ClassDump/CDFatFile.h>
 #import <ClassDump/CDClassDump.h>
 #import <ClassDump/CDExtensions.h>
@@ -17,6 +20,7 @@
 #import <ClassDump/CDLCDylib.h>
 #import <ClassDump/CDLCDynamicSymbolTable.h>
 #import <ClassDump/CDLCEncryptionInfo.h>
+#import <ClassDump/CDLCFunctionStarts.h>
 #import <ClassDump/CDLCRunPath.h>
 #import <ClassDump/CDLCSegment.h>
 #import <ClassDump/CDLCSymbolTable.h>
@@ -63,6 +67,8 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
     CDLCVersionMinimum *_minVersionIOS;
     CDLCSourceVersion *_sourceVersion;
     CDLCBuildVersion *_buildVersion;
+    CDAddressIndex *_addressIndex;
+    CDStringPool *_stringPool;
     // The parts of struct mach_header_64 pulled out so that our property accessors can be synthesized.
     uint32_t _magic;
     cpu_type_t _cputype;
@@ -79,6 +85,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
 - (instancetype)init; {
     if ((self = [super init])) {
         _byteOrder = CDByteOrder_LittleEndian;
+        _stringPool = [[CDStringPool alloc] init];
     }
     
     return self;
@@ -87,6 +94,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
 - (instancetype)initWithData:(NSData *)data filename:(NSString *)filename searchPathState:(CDSearchPathState *)searchPathState; {
     if ((self = [super initWithData:data filename:filename searchPathState:searchPathState])) {
         _byteOrder = CDByteOrder_LittleEndian;
+        _stringPool = [[CDStringPool alloc] init];
         
         CDDataCursor *cursor = [[CDDataCursor alloc] initWithData:data];
         _magic = [cursor readBigInt32];
@@ -126,6 +134,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
         
         NSUInteger headerOffset = _uses64BitABI ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
         CDLogVerbose(@"header offset: %lu", headerOffset);
+        [self adviseAccess:CDMappedDataAccessSequential offset:headerOffset length:_sizeofcmds];
         CDMachOFileDataCursor *fileCursor = [[CDMachOFileDataCursor alloc] initWithFile:self offset:headerOffset];
         [self _readLoadCommands:fileCursor count:_ncmds];
     }
@@ -162,6 +171,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
             else if ([loadCommand isKindOfClass:[CDLCDyldInfo class]])           _dyldInfo = (CDLCDyldInfo *)loadCommand;
             else if ([loadCommand isKindOfClass:[CDLCExportTRIEData class]])     _exportsTrie = (CDLCExportTRIEData *)loadCommand;
             else if ([loadCommand isKindOfClass:[CDLCChainedFixups class]])      _chainedFixups = (CDLCChainedFixups *)loadCommand;
+            else if ([loadCommand isKindOfClass:[CDLCFunctionStarts class]])     _functionStarts = (CDLCFunctionStarts *)loadCommand;
             else if ([loadCommand isKindOfClass:[CDLCRunPath class]]) {
                 [runPaths addObject:[(CDLCRunPath *)loadCommand resolvedRunPath]];
                 [runPathCommands addObject:loadCommand];
@@ -176,6 +186,9 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
     _runPathCommands   = [runPathCommands copy];
     _dyldEnvironment   = [dyldEnvironment copy];
     _reExportedDylibs  = [reExportedDylibs copy];
+    _addressIndex      = [[CDAddressIndex alloc] initWithSegments:(NSArray<CDLCSegment *> *)_segments];
+    
+    [self _adviseSegmentAccess];
     
     for (CDLoadCommand *loadCommand in _loadCommands) {
         [loadCommand machOFileDidReadLoadCommands:self];
@@ -183,6 +196,27 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
     CDLogVerbose_HEX(@"preferredBaseAddress", [self preferredLoadAddress]);
 }
 
+// Linkedit is walked front to back by the load commands that own it, the __objc_* sections are chased pointer by pointer.
+// Only the ObjC sections get prefaulted; everything else is left to fault in on demand.
+- (void)_adviseSegmentAccess; {
+    if (self.mappedData.isMapped == NO)
+        return;
+    
+    for (CDLCSegment *segment in _segments) {
+        if ([segment.name isEqualToString:@"__LINKEDIT"]) {
+            [self adviseAccess:CDMappedDataAccessSequential offset:segment.fileoff length:segment.filesize];
+            continue;
+        }
+        
+        for (CDSection *section in segment.sections) {
+            if ([section.sectionName hasPrefix:@"__objc_"] && section.offset != 0 && section.size != 0) {
+                [self adviseAccess:CDMappedDataAccessRandom offset:section.offset length:section.size];
+                [self adviseAccess:CDMappedDataAccessWillNeed offset:section.offset length:section.size];
+            }
+        }
+    }
+}
+
 #pragma mark - Debugging
 
 - (NSString *)description; {
@@ -289,26 +323,11 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
 }
 
 - (CDLCSegment *)segmentWithName:(NSString *)segmentName; {
-    for (id loadCommand in _loadCommands) {
-        if ([loadCommand isKindOfClass:[CDLCSegment class]] && [[loadCommand name] isEqual:segmentName]) {
-            return loadCommand;
-        }
-    }
-    
-    return nil;
+    return [_addressIndex segmentWithName:segmentName];
 }
 
 - (CDLCSegment *)segmentContainingAddress:(NSUInteger)address; {
-    //CDLog(@"_loadCommands: %@", _loadCommands);
-    for (id loadCommand in _loadCommands) {
-        //CDLog(@"processing load command: %@", loadCommand);
-        if ([loadCommand isKindOfClass:[CDLCSegment class]] && [loadCommand containsAddress:address]) {
-            //CDLog(@"loadCommand: %@ contains address: %lu", loadCommand, address);
-            return loadCommand;
-        }
-    }
-    
-    return nil;
+    return [_addressIndex segmentContainingAddress:address];
 }
 
 - (void)showWarning:(NSString *)warning; {
@@ -340,6 +359,11 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
     if (address == 0)
         return nil;
     
+    NSString *pooledString = [_stringPool stringForAddress:address];
+    if (pooledString != nil)
+        return pooledString;
+    
+    NSUInteger originalAddress = address;
     CDLCSegment *segment = [self segmentContainingAddress:address];
     if (segment == nil && self.chainedFixups) { //check for chain fixup rebase
         uint64_t based = [self.chainedFixups rebaseTargetFromAddress:address];
@@ -368,7 +392,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
             return nil;
         
         ptr = (uint8_t *)[d2 bytes] + d2Offset;
-        return [[NSString alloc] initWithBytes:ptr length:strlen(ptr) encoding:NSASCIIStringEncoding];
+        return [_stringPool internCString:ptr forAddress:originalAddress];
     }
     
     NSUInteger offset = [self dataOffsetForAddress:address];
@@ -376,14 +400,14 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
         return nil;
     
     // Support small methods referencing selector names in __objc_selrefs.
-    CDSection *section = [segment sectionContainingAddress:address];
+    CDSection *section = [_addressIndex sectionContainingAddress:address];
     if ([[section sectionName] isEqualToString:@"__objc_selrefs"]) {
         const void * reference = [self.data bytes] + offset;
         offset = ([self ptrSize] == 8) ? *((uint64_t *)reference) : *((uint32_t *)reference);
     }
     
     ptr = (uint8_t *)[self.data bytes] + offset;
-    NSString *returnString = [[NSString alloc] initWithBytes:ptr length:strlen(ptr) encoding:NSASCIIStringEncoding];
+    NSString *returnString = [_stringPool internCString:ptr forAddress:originalAddress];
     //CDLogVerbose(@"stringAtAddress: %@", returnString);
     return returnString;
 }
@@ -449,41 +473,26 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
         return 0;
     
     CDLogInfo(@"%s: 0x%08lx (%llu)", __PRETTY_FUNCTION__, address, address);
-    CDLCSegment *segment = [self segmentContainingAddress:address];
-    if (segment == nil && self.chainedFixups) {
+    NSUInteger offset = [_addressIndex fileOffsetForAddress:address];
+    if (offset == NSNotFound && self.chainedFixups) {
         CDLogInfo(@"%s nil segment", __PRETTY_FUNCTION__);
         uint64_t based = [self.chainedFixups rebaseTargetFromAddress:address];
         if (based != 0){
             CDLogInfo_HEX(@"based", based);
             address = based;
-            segment = [self segmentContainingAddress:based];
         } else { // no chained fixup found, maybe we need to discard 'extra' frivolous info and 'rebase' to find the data.
             CDLogInfo_HEX(@"\nProblem finding address", address);
             address = [self fixupBasedAddress:address];//bottom + self.preferredLoadAddress;
             CDLogInfo_HEX(@"new value", address);
-            segment = [self segmentContainingAddress:address];
         }
-        if (segment == nil){
+        offset = [_addressIndex fileOffsetForAddress:address];
+        if (offset == NSNotFound){
             CDLog(@"Error: Cannot find offset for address 0x%08lx in dataOffsetForAddress:", address);
             exit(5);
         }
     }
     
-    //    if ([segment isProtected]) {
-    //        CDLog(@"Error: Segment is protected.");
-    //        exit(5);
-    //    }
-    //[self logInfoForAddress:address];
-#if 0
-    CDLog(@"---------->");
-    CDLog(@"segment is: %@", segment);
-    CDLog(@"address: 0x%08x", address);
-    CDLog(@"CDFile offset:    0x%08x", segment.fileoff);
-    CDLog(@"file off for address: 0x%08x", [segment fileOffsetForAddress:address]);
-    //CDLog(@"data offset:      0x%08x", offset + [segment fileOffsetForAddress:address]);
-    CDLog(@"<----------");
-#endif
-    return [segment fileOffsetForAddress:address];
+    return offset != NSNotFound ? offset : 0;
 }
 
 - (const void *)bytes; {
@@ -561,8 +570,8 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
 - (uint64_t)peekPtrAtOffset:(NSUInteger)offset ptrSize:(NSUInteger)ptrSize {
     uint64_t val = 0;
     switch (ptrSize) {
-        case sizeof(uint32_t): val = [self peekInt32:offset];
-        case sizeof(uint64_t): val = [self peekInt64:offset];
+        case sizeof(uint32_t): val = [self peekInt32:offset]; break;
+        case sizeof(uint64_t): val = [self peekInt64:offset]; break;
     }
     return val;
 }
@@ -571,6 +580,39 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
     return (uint8_t *)[self.data bytes] + offset;
 }
 
+- (NSData *)dataViewAtOffset:(NSUInteger)offset length:(NSUInteger)length; {
+    NSUInteger dataLength = [self.data length];
+    if (offset > dataLength) {
+        CDLog(@"Warning: data view offset %lu is past the end of the file (%lu)", offset, dataLength);
+        offset = dataLength;
+    }
+    if (length > dataLength - offset) {
+        CDLog(@"Warning: data view at offset %lu truncated from %lu to %lu bytes", offset, length, dataLength - offset);
+        length = dataLength - offset;
+    }
+    
+    return [[CDDataView alloc] initWithData:self.data range:NSMakeRange(offset, length)];
+}
+
+- (CDMappedData *)mappedData; {
+    NSData *data = self.data;
+    if ([data isKindOfClass:[CDDataView class]])
+        data = [(CDDataView *)data backingData];
+    
+    return [data isKindOfClass:[CDMappedData class]] ? (CDMappedData *)data : nil;
+}
+
+- (void)adviseAccess:(CDMappedDataAccess)access offset:(NSUInteger)offset length:(NSUInteger)length; {
+    NSData *data = self.data;
+    if ([data isKindOfClass:[CDDataView class]]) {
+        offset += [(CDDataView *)data range].location;
+        data = [(CDDataView *)data backingData];
+    }
+    
+    if ([data isKindOfClass:[CDMappedData class]])
+        [(CDMappedData *)data adviseAccess:access range:NSMakeRange(offset, length)];
+}
+
 - (NSString *)importBaseName; {
     if ([self filetype] == MH_DYLIB) {
         return CDImportNameForPath(self.filename);
@@ -659,7 +701,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
             CDLog(@"No segment contains address: %016lx", address);
         } else {
             CDLog(@"Found address %016lx in segment, sections= %@", address, [segment sections]);
-            CDSection *section = [segment sectionContainingAddress:address];
+            CDSection *section = [_addressIndex sectionContainingAddress:address];
             if (section == nil) {
                 CDLog(@"Found address %016lx in segment %@, but not in a section", address, [segment name]);
             } else {
@@ -680,7 +722,7 @@ static NSString *CDMachOFileMagicNumberDescription(uint32_t magic) {
     CDRelocationInfo *rinfo = [self.dynamicSymbolTable relocationEntryWithOffset:address - [self.symbolTable baseAddress]];
     CDLogVerbose(@"rinfo: %@", rinfo);
     if (rinfo != nil) {
-        CDSymbol *symbol = [[self.symbolTable symbols] objectAtIndex:rinfo.symbolnum];
+        CDSymbol *symbol = [self.symbolTable symbolAtIndex:rinfo.symbolnum];
         CDLogVerbose(@"symbol: %@", symbol);
         
         // Now we could use GET_LIBRARY_ORDINAL(), look up the the appropriate mach-o file (being sure to have loaded them even without -r),
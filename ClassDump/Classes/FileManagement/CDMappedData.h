@@ -0,0 +1,52 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, CDFileLoadingMode) {
+    CDFileLoadingModeAutomatic = 0, // mmap regular files, stream everything else (pipes, stdin)
+    CDFileLoadingModeMapped,        // mmap only, fail if the input can't be mapped
+    CDFileLoadingModeRead,          // always read the whole file into memory
+};
+
+typedef NS_ENUM(NSUInteger, CDMappedDataAccess) {
+    CDMappedDataAccessNormal = 0,
+    CDMappedDataAccessSequential, // load commands, linkedit
+    CDMappedDataAccessRandom,     // __objc_* pointer chasing
+    CDMappedDataAccessWillNeed,   // prefault
+};
+
+typedef struct {
+    uint64_t mappedBytes;
+    uint64_t streamedBytes;
+    uint64_t sequentialBytes;
+    uint64_t randomBytes;
+    uint64_t prefaultedBytes;
+    uint64_t residentBytes;
+    // Process wide page fault counts since the data was loaded.
+    int64_t minorFaults;
+    int64_t majorFaults;
+} CDMappedDataStatistics;
+
+// Backing store for the contents of a file.  Regular files are mapped read-only, anything that can't be mapped
+// is streamed into memory.  Access hints are only forwarded to the kernel for mapped data.
+@interface CDMappedData : NSData
+
+// A filename of "-" reads from standard input.
++ (nullable instancetype)dataWithContentsOfFile:(NSString *)filename loadingMode:(CDFileLoadingMode)loadingMode error:(NSError **)error;
+
+@property (readonly) NSString *filename;
+@property (readonly, getter=isMapped) BOOL mapped;
+
+- (void)adviseAccess:(CDMappedDataAccess)access range:(NSRange)range;
+
+@property (readonly) CDMappedDataStatistics statistics;
+- (NSString *)statisticsDescription;
+
+@end
+
+NS_ASSUME_NONNULL_END
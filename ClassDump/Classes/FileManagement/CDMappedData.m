@@ -0,0 +1,234 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDMappedData.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#import <ClassDump/ClassDumpUtils.h>
+
+static const size_t CDMappedDataReadChunkSize = 1024 * 1024;
+
+static NSError *CDMappedDataPOSIXError(int code, NSString *filename)
+{
+    NSDictionary *userInfo = @{
+        NSFilePathErrorKey               : filename,
+        NSLocalizedFailureReasonErrorKey : [NSString stringWithUTF8String:strerror(code)],
+    };
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:code userInfo:userInfo];
+}
+
+@implementation CDMappedData
+{
+    NSString *_filename;
+    void *_mappedBytes;
+    size_t _mappedLength;
+    NSMutableData *_streamedData;
+
+    CDMappedDataStatistics _statistics;
+    struct rusage _initialUsage;
+}
+
++ (instancetype)dataWithContentsOfFile:(NSString *)filename loadingMode:(CDFileLoadingMode)loadingMode error:(NSError **)error;
+{
+    BOOL isStandardInput = [filename isEqualToString:@"-"];
+    int fd = isStandardInput ? STDIN_FILENO : open([filename fileSystemRepresentation], O_RDONLY);
+    if (fd < 0) {
+        if (error != NULL)
+            *error = CDMappedDataPOSIXError(errno, filename);
+        return nil;
+    }
+
+    CDMappedData *data = [[self alloc] initWithFileDescriptor:fd filename:filename loadingMode:loadingMode error:error];
+    if (isStandardInput == NO)
+        close(fd);
+
+    return data;
+}
+
+- (instancetype)initWithFileDescriptor:(int)fd filename:(NSString *)filename loadingMode:(CDFileLoadingMode)loadingMode error:(NSError **)error;
+{
+    if ((self = [super init])) {
+        _filename = filename;
+        getrusage(RUSAGE_SELF, &_initialUsage);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            if (error != NULL)
+                *error = CDMappedDataPOSIXError(errno, filename);
+            return nil;
+        }
+
+        BOOL canMap = S_ISREG(st.st_mode) && st.st_size > 0;
+        if (loadingMode == CDFileLoadingModeMapped && canMap == NO) {
+            if (error != NULL)
+                *error = CDMappedDataPOSIXError(ENODEV, filename);
+            return nil;
+        }
+
+        if (canMap && loadingMode != CDFileLoadingModeRead) {
+            void *bytes = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (bytes != MAP_FAILED) {
+                _mappedBytes = bytes;
+                _mappedLength = (size_t)st.st_size;
+                _statistics.mappedBytes = _mappedLength;
+                return self;
+            }
+
+            if (loadingMode == CDFileLoadingModeMapped) {
+                if (error != NULL)
+                    *error = CDMappedDataPOSIXError(errno, filename);
+                return nil;
+            }
+            CDLogVerbose(@"mmap() failed for %@ (%s), falling back to read()", filename, strerror(errno));
+        }
+
+        // Not seekable, or mapping isn't wanted.  Pull the whole thing in.
+        NSUInteger capacity = S_ISREG(st.st_mode) ? (NSUInteger)st.st_size : CDMappedDataReadChunkSize;
+        _streamedData = [[NSMutableData alloc] initWithCapacity:capacity];
+        uint8_t *buffer = malloc(CDMappedDataReadChunkSize);
+        if (buffer == NULL) {
+            if (error != NULL)
+                *error = CDMappedDataPOSIXError(ENOMEM, filename);
+            return nil;
+        }
+
+        for (;;) {
+            ssize_t count = read(fd, buffer, CDMappedDataReadChunkSize);
+            if (count == 0)
+                break;
+            if (count < 0) {
+                if (errno == EINTR)
+                    continue;
+                int code = errno;
+                free(buffer);
+                if (error != NULL)
+                    *error = CDMappedDataPOSIXError(code, filename);
+                return nil;
+            }
+            [_streamedData appendBytes:buffer length:(NSUInteger)count];
+        }
+        free(buffer);
+        _statistics.streamedBytes = [_streamedData length];
+    }
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    if (_mappedBytes != NULL) {
+        munmap(_mappedBytes, _mappedLength);
+    }
+}
+
+#pragma mark - NSData primitives
+
+- (const void *)bytes;
+{
+    return _mappedBytes != NULL ? _mappedBytes : [_streamedData bytes];
+}
+
+- (NSUInteger)length;
+{
+    return _mappedBytes != NULL ? _mappedLength : [_streamedData length];
+}
+
+- (id)copyWithZone:(NSZone *)zone;
+{
+    return self;
+}
+
+#pragma mark -
+
+- (BOOL)isMapped;
+{
+    return _mappedBytes != NULL;
+}
+
+- (void)adviseAccess:(CDMappedDataAccess)access range:(NSRange)range;
+{
+    if (_mappedBytes == NULL || range.length == 0 || range.location >= _mappedLength)
+        return;
+
+    if (NSMaxRange(range) > _mappedLength)
+        range.length = _mappedLength - range.location;
+
+    // madvise() wants page aligned addresses.
+    uintptr_t pageMask = (uintptr_t)getpagesize() - 1;
+    uintptr_t start = ((uintptr_t)_mappedBytes + range.location) & ~pageMask;
+    uintptr_t end = (uintptr_t)_mappedBytes + NSMaxRange(range);
+
+    int advice = MADV_NORMAL;
+    switch (access) {
+        case CDMappedDataAccessNormal:     advice = MADV_NORMAL; break;
+        case CDMappedDataAccessSequential: advice = MADV_SEQUENTIAL; break;
+        case CDMappedDataAccessRandom:     advice = MADV_RANDOM; break;
+        case CDMappedDataAccessWillNeed:   advice = MADV_WILLNEED; break;
+    }
+
+    if (madvise((void *)start, end - start, advice) != 0) {
+        CDLogVerbose(@"madvise(%d) failed for %@: %s", advice, _filename, strerror(errno));
+        return;
+    }
+
+    @synchronized (self) {
+        switch (access) {
+            case CDMappedDataAccessNormal:     break;
+            case CDMappedDataAccessSequential: _statistics.sequentialBytes += range.length; break;
+            case CDMappedDataAccessRandom:     _statistics.randomBytes += range.length; break;
+            case CDMappedDataAccessWillNeed:   _statistics.prefaultedBytes += range.length; break;
+        }
+    }
+}
+
+- (CDMappedDataStatistics)statistics;
+{
+    CDMappedDataStatistics statistics;
+    @synchronized (self) {
+        statistics = _statistics;
+    }
+
+    if (_mappedBytes != NULL) {
+        size_t pageSize = (size_t)getpagesize();
+        size_t pageCount = (_mappedLength + pageSize - 1) / pageSize;
+        char *vector = malloc(pageCount);
+        if (vector != NULL) {
+            if (mincore(_mappedBytes, _mappedLength, vector) == 0) {
+                uint64_t residentPages = 0;
+                for (size_t index = 0; index < pageCount; index++) {
+                    if (vector[index] & MINCORE_INCORE)
+                        residentPages++;
+                }
+                statistics.residentBytes = residentPages * pageSize;
+            }
+            free(vector);
+        }
+    } else {
+        statistics.residentBytes = [_streamedData length];
+    }
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        statistics.minorFaults = usage.ru_minflt - _initialUsage.ru_minflt;
+        statistics.majorFaults = usage.ru_majflt - _initialUsage.ru_majflt;
+    }
+
+    return statistics;
+}
+
+- (NSString *)statisticsDescription;
+{
+    CDMappedDataStatistics statistics = self.statistics;
+    return [NSString stringWithFormat:@"%@: mapped: %llu, streamed: %llu, sequential: %llu, random: %llu, prefaulted: %llu, resident: %llu, faults: %lld minor / %lld major",
+            [_filename lastPathComponent],
+            statistics.mappedBytes, statistics.streamedBytes, statistics.sequentialBytes, statistics.randomBytes,
+            statistics.prefaultedBytes, statistics.residentBytes, statistics.minorFaults, statistics.majorFaults];
+}
+
+@end
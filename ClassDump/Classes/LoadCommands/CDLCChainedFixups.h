@@ -10,11 +10,30 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+typedef NS_ENUM(uint8_t, CDChainedFixupKind) {
+    CDChainedFixupKindRebase,
+    CDChainedFixupKindBind,
+};
+
+typedef struct {
+    uint64_t offset;       // File offset of the fixup location
+    uint64_t raw;          // Chained pointer as stored in the file
+    uint64_t target;       // Rebase: unpacked target address.  Bind: import ordinal
+    uint32_t segmentIndex;
+    uint16_t pageIndex;
+    CDChainedFixupKind kind;
+} CDChainedFixup;
+
 @interface CDLCChainedFixups : CDLoadCommand
 - (NSUInteger)rebaseTargetFromAddress:(NSUInteger)address adjustment:(NSUInteger)adj;
 - (NSUInteger)rebaseTargetFromAddress:(NSUInteger)address;
 - (NSString *)symbolNameForAddress:(NSUInteger)address;
+- (nullable NSString *)symbolNameForImportOrdinal:(uint32_t)ordinal;
 - (NSString *)externalClassNameForAddress:(NSUInteger)address;
+
+// Every fixup in the image, sorted by segment, page and offset.  The page chains are decoded in parallel the
+// first time this is called; the table lives as long as the load command.
+- (const CDChainedFixup *)fixupsWithCount:(NSUInteger *)count NS_RETURNS_INNER_POINTER;
 @end
 
 NS_ASSUME_NONNULL_END
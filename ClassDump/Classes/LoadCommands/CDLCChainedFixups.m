@@ -10,9 +10,15 @@
 /**
  
  A few notes about this class, it was originally based around how binding an rebasing worked in CDLCDyldInfo
- therefore a similar paradigm is kept utilizing the _symbolNamesByAddress
- 
+ which walked every fixup up front into dictionaries keyed by the raw pointer value.
  
+ Lookups are still keyed by the raw (chained) pointer value the caller read out of the file, but a chained
+ pointer carries everything needed to resolve it: a rebase holds its target, a bind holds its import ordinal.
+ So nothing is walked until someone asks; each query decodes just the pointer it was given, after checking
+ that it is well formed for the pointer format(s) used in this image.
+ The full page walk only happens when the whole table is asked for (dumping the fixups with -F).  Every page
+ chain starts at its own page_start, so the pages are decoded in parallel and the results concatenated, which
+ leaves the table sorted without a separate sort.
  
  */
 
@@ -27,13 +33,100 @@
 #import <ClassDump/CDClassDump.h>
 #import <ClassDump/CDExtensions.h>
 
+// The pointer formats CDDecodeChainedFixupPage() understands, as a bit set.
+#define CDChainedPointerFormatBit(format) (1u << (format))
+static const uint32_t CDSupportedChainedPointerFormats = CDChainedPointerFormatBit(DYLD_CHAINED_PTR_64) | CDChainedPointerFormatBit(DYLD_CHAINED_PTR_64_OFFSET);
+
+typedef struct {
+    const struct dyld_chained_starts_in_segment *startsInSegment;
+    uint32_t segmentIndex;
+    uint16_t pageIndex;
+} CDChainedFixupPage;
+
+typedef struct {
+    CDChainedFixup *fixups;
+    NSUInteger count;
+    NSUInteger capacity;
+} CDChainedFixupBuffer;
+
+static uint64_t CDChainedRebaseTarget(uint64_t raw, uint16_t pointerFormat, uint64_t preferredLoadAddress)
+{
+    struct dyld_chained_ptr_64_rebase rebase = *(struct dyld_chained_ptr_64_rebase *)&raw;
+    uint64_t unpackedTarget = (((uint64_t)rebase.high8) << 56) | (uint64_t)(rebase.target);
+    // The DYLD_CHAINED_PTR_64 target is vmaddr, but
+    // DYLD_CHAINED_PTR_64_OFFSET target is vmoffset. Need to add preferredLoadAddress to find it! -- major missing piece to getting this working.
+    if (pointerFormat == DYLD_CHAINED_PTR_64_OFFSET) {
+        unpackedTarget += preferredLoadAddress;
+    }
+    return unpackedTarget;
+}
+
+// Appends the fixups of one page chain to buffer.  Pure C, so it can run on any thread.
+static void CDDecodeChainedFixupPage(const CDChainedFixupPage *page, const uint8_t *base, NSUInteger length,
+                                     uint64_t preferredLoadAddress, CDChainedFixupBuffer *buffer)
+{
+    const struct dyld_chained_starts_in_segment *segment = page->startsInSegment;
+    if ((CDSupportedChainedPointerFormats & CDChainedPointerFormatBit(segment->pointer_format)) == 0)
+        return;
+    
+    uint64_t chain = segment->segment_offset + (uint64_t)segment->page_size * page->pageIndex + segment->page_start[page->pageIndex];
+    for (;;) {
+        if (chain + sizeof(uint64_t) > length)
+            break;
+        
+        if (buffer->count == buffer->capacity) {
+            buffer->capacity = MAX(buffer->capacity * 2, 256);
+            buffer->fixups = reallocf(buffer->fixups, buffer->capacity * sizeof(CDChainedFixup));
+            if (buffer->fixups == NULL) {
+                buffer->count = buffer->capacity = 0;
+                return;
+            }
+        }
+        
+        uint64_t raw = OSReadLittleInt64(base, chain);
+        struct dyld_chained_ptr_64_bind bind = *(struct dyld_chained_ptr_64_bind *)&raw;
+        CDChainedFixup *fixup = &buffer->fixups[buffer->count++];
+        fixup->offset       = chain;
+        fixup->raw          = raw;
+        fixup->segmentIndex = page->segmentIndex;
+        fixup->pageIndex    = page->pageIndex;
+        if (bind.bind) {
+            fixup->kind   = CDChainedFixupKindBind;
+            fixup->target = bind.ordinal;
+        } else {
+            fixup->kind   = CDChainedFixupKindRebase;
+            fixup->target = CDChainedRebaseTarget(raw, segment->pointer_format, preferredLoadAddress);
+        }
+        
+        if (bind.next == 0)
+            break;
+        chain += bind.next * 4;
+    }
+}
+
 @implementation CDLCChainedFixups {
     struct linkedit_data_command _linkeditDataCommand;
     NSData *_linkeditData;
     NSUInteger _ptrSize;
-    NSMutableDictionary<NSNumber *, NSString *> *_symbolNamesByAddress;
-    NSMutableDictionary<NSNumber *, NSNumber *> *_based;
-    NSMutableDictionary<NSString *, NSString *> *_imports;
+    BOOL _printFixupData;
+    
+    // Set up in machOFileDidReadLoadCommands:, all pointing into the linkedit data.
+    const uint8_t *_importTable;
+    uint32_t _importsFormat;
+    const char *_symbolStrings;
+    NSUInteger _symbolStringsLength;
+    uint32_t _importCount;
+    uint32_t _pointerFormats; // Bit set of the formats used by the segments
+    
+    const uint8_t *_fixupBase;
+    const struct dyld_chained_starts_in_image *_startsInImage;
+    
+    NSMutableArray *_importNames; // Indexed by ordinal, NSNull until first used
+    NSMutableDictionary<NSString *, NSString *> *_imports; // Only filled in when printing
+    
+    BOOL _fixupsDecoded;
+    CDChainedFixup *_fixups;
+    NSUInteger _fixupCount;
 }
 
 
@@ -70,61 +163,6 @@ static void printChainedFixupsHeader(struct dyld_chained_fixups_header *header)
 
 //symbol_offset_address = (virtual_symbol_address - containing_macho_section_virtual_address) + contain_macho_section_file_offset
 
-- (void)processFixupsInPage:(uint8_t *)base fixupBase:(uint8_t*)fixupBase header:(struct dyld_chained_fixups_header *)header startsIn:(struct dyld_chained_starts_in_segment *)segment page:(int)pageIndex {
-    uint32_t chain = (uint32_t)segment->segment_offset + segment->page_size * pageIndex + segment->page_start[pageIndex];
-    bool done = false;
-    int count = 0;
-    while (!done) {
-        if (segment->pointer_format == DYLD_CHAINED_PTR_64
-            || segment->pointer_format == DYLD_CHAINED_PTR_64_OFFSET) {
-            struct dyld_chained_ptr_64_bind bind = *(struct dyld_chained_ptr_64_bind *)(base + chain);
-            if (bind.bind) { //we are binding a symbol
-                
-                struct dyld_chained_import import = ((struct dyld_chained_import *)(fixupBase + header->imports_offset))[bind.ordinal];
-                char *symbol = (char *)(fixupBase + header->symbols_offset + import.name_offset);
-                uint64_t peeked = [self.machOFile peekPtrAtOffset:chain ptrSize:_ptrSize];
-                uint64_t raw = _OSSwapInt64(peeked); //honestly not sure why byte swapping is 'necessary' here, but it works.
-
-                if ([CDClassDump printFixupData]){
-                    NSString *lib = _imports[[NSString stringWithUTF8String:symbol]];
-                    fprintf(stderr,"        0x%08x RAW: %#010llx  BIND     ordinal: %d   addend: %d    dylib: %s   (%s)\n",
-                            chain, raw, bind.ordinal, bind.addend, [lib UTF8String], symbol);
-                }
-                [self bindAddress:raw symbolName:symbol];
-            } else {
-                // rebase 0x%08lx
-                struct dyld_chained_ptr_64_rebase rebase = *(struct dyld_chained_ptr_64_rebase *)&bind;
-                
-                uint64_t raw = [self.machOFile peekPtrAtOffset:chain ptrSize:_ptrSize];
-                uint64_t unpackedTarget = (((uint64_t)rebase.high8) << 56) | (uint64_t)(rebase.target);
-                // The DYLD_CHAINED_PTR_64 target is vmaddr, but
-                // DYLD_CHAINED_PTR_64_OFFSET target is vmoffset. Need to add preferredLoadAddress to find it! -- major missing piece to getting this working.
-                if (segment->pointer_format == DYLD_CHAINED_PTR_64_OFFSET) {
-                    unpackedTarget += self.machOFile.preferredLoadAddress;
-                    //CDLogVerbose_HEX(@"unpackedTarget adjusted", unpackedTarget);
-                }
-                if ([CDClassDump printFixupData]){
-                    fprintf(stderr,"        %#010x RAW: %#010llx REBASE   target: %#010llx   high8: %#010x\n",
-                            chain, raw, unpackedTarget, rebase.high8);
-                }
-                
-                [self rebaseAddress:raw target:unpackedTarget];
-            }
-            
-            if (bind.next == 0) {
-                done = true;
-            } else {
-                chain += bind.next * 4;
-            }
-            
-        } else {
-            printf("Unsupported pointer format: 0x%x", segment->pointer_format);
-            break;
-        }
-        count++;
-    }
-}
-
 - (NSString *) getDylibName:(uint16_t) dylibOrdinal {
     NSString *dylibName = nil;
 
@@ -184,9 +222,7 @@ static void printChainedFixupsHeader(struct dyld_chained_fixups_header *header)
 }
 
 - (void)printImports:(struct dyld_chained_fixups_header *)header {
-    if([CDClassDump printFixupData]){
-        fprintf(stderr,"  IMPORTS\n");
-    }
+    fprintf(stderr,"  IMPORTS\n");
     int importCount = 0;
     for (int i = 0; i < header->imports_count; ++i) {
         struct dyld_chained_import import =
@@ -196,17 +232,13 @@ static void printChainedFixupsHeader(struct dyld_chained_fixups_header *header)
         char * symbol = (char *)((uint8_t *)header + header->symbols_offset + import.name_offset);
         _imports[[NSString stringWithUTF8String:symbol]] = dylibName;
         
-        if([CDClassDump printFixupData]){
-            fprintf(stderr,"    [%d] lib_ordinal: %-22s   weak_import: %d   name_offset: %d (%s)\n",
-                   i, [[self getDylibName:import.lib_ordinal] UTF8String], import.weak_import, import.name_offset,
-                    symbol);
-        }
+        fprintf(stderr,"    [%d] lib_ordinal: %-22s   weak_import: %d   name_offset: %d (%s)\n",
+               i, [[self getDylibName:import.lib_ordinal] UTF8String], import.weak_import, import.name_offset,
+                symbol);
         importCount++;
     }
-    if([CDClassDump printFixupData]){
-        fprintf(stderr,"\n");
-        CDLogInfo(@"imports: %@", _imports);
-    }
+    fprintf(stderr,"\n");
+    CDLogInfo(@"imports: %@", _imports);
 }
 
 static void formatPointerFormat(uint16_t pointer_format, char *formatted) {
@@ -235,8 +267,7 @@ static void formatPointerFormat(uint16_t pointer_format, char *formatted) {
         _linkeditDataCommand.dataoff  = [cursor readInt32];
         _linkeditDataCommand.datasize = [cursor readInt32];
         _ptrSize = [[cursor machOFile] ptrSize];
-        _symbolNamesByAddress = [NSMutableDictionary new];
-        _based = [NSMutableDictionary new];
+        _printFixupData = [CDClassDump printFixupData];
         _imports = [NSMutableDictionary new];
     }
     
@@ -255,7 +286,7 @@ static void formatPointerFormat(uint16_t pointer_format, char *formatted) {
 
 - (NSData *)linkeditData; {
     if (_linkeditData == NULL) {
-        _linkeditData = [[NSData alloc] initWithBytes:[self.machOFile bytesAtOffset:_linkeditDataCommand.dataoff] length:_linkeditDataCommand.datasize];
+        _linkeditData = [self.machOFile dataViewAtOffset:_linkeditDataCommand.dataoff length:_linkeditDataCommand.datasize];
     }
     
     return _linkeditData;
@@ -276,8 +307,46 @@ static void formatPointerFormat(uint16_t pointer_format, char *formatted) {
     return nil;
 }
 
+#pragma mark - Decoding
+
+- (NSString *)symbolNameForImportOrdinal:(uint32_t)ordinal {
+    if (ordinal >= _importCount)
+        return nil;
+    
+    @synchronized (self) {
+        id name = _importNames[ordinal];
+        if (name != [NSNull null])
+            return name;
+        
+        uint32_t nameOffset = 0;
+        switch (_importsFormat) {
+            case DYLD_CHAINED_IMPORT:          nameOffset = ((const struct dyld_chained_import *)_importTable)[ordinal].name_offset; break;
+            case DYLD_CHAINED_IMPORT_ADDEND:   nameOffset = ((const struct dyld_chained_import_addend *)_importTable)[ordinal].name_offset; break;
+            case DYLD_CHAINED_IMPORT_ADDEND64: nameOffset = ((const struct dyld_chained_import_addend64 *)_importTable)[ordinal].name_offset; break;
+        }
+        if (nameOffset >= _symbolStringsLength || memchr(_symbolStrings + nameOffset, 0, _symbolStringsLength - nameOffset) == NULL)
+            return nil;
+        
+        name = [[NSString alloc] initWithUTF8String:_symbolStrings + nameOffset];
+        if (name != nil)
+            _importNames[ordinal] = name;
+        return name;
+    }
+}
+
+// The address is the byte swapped raw pointer value, which is what the ObjC processor has been passing in all along.
+// Like rebaseTargetFromAddress:, only images whose pointers are in a format we understand are decoded, otherwise any
+// value with the top bit set would turn into an import.
 - (NSString *)symbolNameForAddress:(NSUInteger)address; {
-    return [_symbolNamesByAddress objectForKey:[NSNumber numberWithUnsignedInteger:address]];
+    if (address == 0 || _importCount == 0 || (_pointerFormats & CDSupportedChainedPointerFormats) == 0)
+        return nil;
+    
+    uint64_t raw = _OSSwapInt64(address);
+    struct dyld_chained_ptr_64_bind bind = *(struct dyld_chained_ptr_64_bind *)&raw;
+    if (bind.bind == 0 || bind.zero != 0 || bind.reserved != 0 || bind.ordinal >= _importCount)
+        return nil;
+    
+    return [self symbolNameForImportOrdinal:bind.ordinal];
 }
 
 - (NSUInteger)rebaseTargetFromAddress:(NSUInteger)address {
@@ -287,88 +356,233 @@ static void formatPointerFormat(uint16_t pointer_format, char *formatted) {
 //refactor, the adjustment should never be needed again.
 - (NSUInteger)rebaseTargetFromAddress:(NSUInteger)address adjustment:(NSUInteger)adj {
     CDLogInfo(@"%s : %#010llx (%lu)", __PRETTY_FUNCTION__, address-adj, address-adj);
-    NSNumber *key = [NSNumber numberWithUnsignedInteger:address-adj]; // I don't think 32-bit will dump 64-bit stuff.
-    return [_based[key] unsignedIntegerValue];
+    uint64_t raw = address - adj; // I don't think 32-bit will dump 64-bit stuff.
+    if (raw == 0)
+        return 0;
+    
+    struct dyld_chained_ptr_64_rebase rebase = *(struct dyld_chained_ptr_64_rebase *)&raw;
+    if (rebase.bind != 0 || rebase.reserved != 0)
+        return 0;
+    
+    // Only a pointer whose target lands inside this image can have come from a rebase.  If the image mixes
+    // formats, the first one that makes sense wins.
+    for (uint16_t format = DYLD_CHAINED_PTR_64; format <= DYLD_CHAINED_PTR_64_OFFSET; format++) {
+        if ((_pointerFormats & CDChainedPointerFormatBit(format) & CDSupportedChainedPointerFormats) == 0)
+            continue;
+        
+        uint64_t target = CDChainedRebaseTarget(raw, format, self.machOFile.preferredLoadAddress);
+        if ([self.machOFile segmentContainingAddress:target] != nil)
+            return target;
+    }
+    
+    return 0;
 }
 
-- (void)rebaseAddress:(uint64_t)address target:(uint64_t)target {
-    NSNumber *key = [NSNumber numberWithUnsignedInteger:address]; // I don't think 32-bit will dump 64-bit stuff.
-    NSNumber *val = [NSNumber numberWithUnsignedInteger:target];
-    _based[key] = val;
+#pragma mark -
+
+- (void)machOFileDidReadLoadCommands:(CDMachOFile *)machOFile; {
+    NSData *linkeditData = [self linkeditData];
+    uint8_t *fixup_base = (uint8_t *)[linkeditData bytes];
+    NSUInteger fixupLength = [linkeditData length];
+    struct dyld_chained_fixups_header *header = (struct dyld_chained_fixups_header *)fixup_base;
+    if (fixupLength < sizeof(struct dyld_chained_fixups_header) || header->starts_offset >= fixupLength) {
+        CDLog(@"Warning: chained fixups data is truncated (%lu bytes)", fixupLength);
+        return;
+    }
+    
+    NSUInteger importSize = 0;
+    switch (header->imports_format) {
+        case DYLD_CHAINED_IMPORT:          importSize = sizeof(struct dyld_chained_import); break;
+        case DYLD_CHAINED_IMPORT_ADDEND:   importSize = sizeof(struct dyld_chained_import_addend); break;
+        case DYLD_CHAINED_IMPORT_ADDEND64: importSize = sizeof(struct dyld_chained_import_addend64); break;
+    }
+    if (importSize != 0
+        && header->imports_offset <= fixupLength
+        && header->imports_count <= (fixupLength - header->imports_offset) / importSize
+        && header->symbols_offset <= fixupLength) {
+        _importTable         = fixup_base + header->imports_offset;
+        _importsFormat       = header->imports_format;
+        _importCount         = header->imports_count;
+        _symbolStrings       = (const char *)(fixup_base + header->symbols_offset);
+        _symbolStringsLength = fixupLength - header->symbols_offset;
+    }
+    _importNames = [[NSMutableArray alloc] initWithCapacity:_importCount];
+    for (uint32_t index = 0; index < _importCount; index++)
+        [_importNames addObject:[NSNull null]];
+    
+    // Only the per-segment pointer formats are needed to answer queries.  The chains themselves are left alone.
+    struct dyld_chained_starts_in_image *starts_in_image =
+    (struct dyld_chained_starts_in_image *)(fixup_base + header->starts_offset);
+    _fixupBase     = fixup_base;
+    _startsInImage = starts_in_image;
+    uint32_t *offsets = starts_in_image->seg_info_offset;
+    for (uint32_t i = 0; i < starts_in_image->seg_count; ++i) {
+        if (offsets[i] == 0 || header->starts_offset + offsets[i] + sizeof(struct dyld_chained_starts_in_segment) > fixupLength)
+            continue;
+        
+        struct dyld_chained_starts_in_segment* startsInSegment = (struct dyld_chained_starts_in_segment*)(fixup_base + header->starts_offset + offsets[i]);
+        if (startsInSegment->pointer_format < 32)
+            _pointerFormats |= CDChainedPointerFormatBit(startsInSegment->pointer_format);
+    }
+    
+    if (_printFixupData) {
+        [self printFixups:header];
+    }
 }
 
-- (void)bindAddress:(uint64_t)address symbolName:(const char *)symbolName {
-    NSNumber *key = [NSNumber numberWithUnsignedInteger:address]; // I don't think 32-bit will dump 64-bit stuff.
-    NSString *str = [[NSString alloc] initWithUTF8String:symbolName];
-    _symbolNamesByAddress[key] = str;
+- (void)dealloc {
+    free(_fixups);
 }
 
-//obsolete, leaving in here in case i ever need those other details and save this in a less hacky fashion
-- (void)bindAddress:(uint64_t)address type:(uint8_t)type symbolName:(const char *)symbolName flags:(uint8_t)flags
-             addend:(int64_t)addend libraryOrdinal:(int64_t)libraryOrdinal; {
-#if 0
-    CDLogVerbose(@"    Bind address: %016lx, type: 0x%02x, flags: %02x, addend: %016lx, libraryOrdinal: %ld, symbolName: %s",
-               address, type, flags, addend, libraryOrdinal, symbolName);
-#endif
-    
-    NSNumber *key = [NSNumber numberWithUnsignedInteger:address]; // I don't think 32-bit will dump 64-bit stuff.
-    NSString *str = [[NSString alloc] initWithUTF8String:symbolName];
-    _symbolNamesByAddress[key] = str;
+#pragma mark - Full table
+
+- (const CDChainedFixup *)fixupsWithCount:(NSUInteger *)count {
+    @synchronized (self) {
+        if (_fixupsDecoded == NO) {
+            [self _decodeAllFixups];
+            _fixupsDecoded = YES;
+        }
+    }
+    
+    if (count != NULL)
+        *count = _fixupCount;
+    return _fixups;
 }
 
-- (void)machOFileDidReadLoadCommands:(CDMachOFile *)machOFile; {
-    uint8_t *fixup_base = (uint8_t *)[[self linkeditData] bytes];
-    struct dyld_chained_fixups_header *header = (struct dyld_chained_fixups_header *)fixup_base;
+- (void)_decodeAllFixups {
+    if (_startsInImage == NULL)
+        return;
+    
+    NSUInteger linkeditLength = [[self linkeditData] length];
+    NSUInteger startsOffset = (const uint8_t *)_startsInImage - _fixupBase;
+    const uint32_t *offsets = _startsInImage->seg_info_offset;
+    
+    // Collect every page that has a chain.
+    NSUInteger pageCount = 0, pageCapacity = 0;
+    CDChainedFixupPage *pages = NULL;
+    for (uint32_t i = 0; i < _startsInImage->seg_count; ++i) {
+        if (offsets[i] == 0 || startsOffset + offsets[i] + sizeof(struct dyld_chained_starts_in_segment) > linkeditLength)
+            continue;
+        
+        const struct dyld_chained_starts_in_segment *startsInSegment = (const struct dyld_chained_starts_in_segment *)((const uint8_t *)_startsInImage + offsets[i]);
+        for (uint16_t j = 0; j < startsInSegment->page_count; ++j) {
+            if (startsInSegment->page_start[j] == DYLD_CHAINED_PTR_START_NONE)
+                continue;
+            
+            if (pageCount == pageCapacity) {
+                pageCapacity = MAX(pageCapacity * 2, 64);
+                pages = reallocf(pages, pageCapacity * sizeof(CDChainedFixupPage));
+                if (pages == NULL)
+                    return;
+            }
+            pages[pageCount++] = (CDChainedFixupPage){ .startsInSegment = startsInSegment, .segmentIndex = i, .pageIndex = j };
+        }
+    }
+    
+    if (pageCount == 0) {
+        free(pages);
+        return;
+    }
+    
+    // Hand out runs of consecutive pages, a few per CPU so uneven chains still balance out.  Each run fills its
+    // own buffer, and since the runs are in page order, concatenating them keeps the table sorted.
+    NSUInteger runCount = MIN(pageCount, [[NSProcessInfo processInfo] activeProcessorCount] * 8);
+    NSUInteger pagesPerRun = (pageCount + runCount - 1) / runCount;
+    runCount = (pageCount + pagesPerRun - 1) / pagesPerRun;
+    CDChainedFixupBuffer *buffers = calloc(runCount, sizeof(CDChainedFixupBuffer));
+    if (buffers == NULL) {
+        free(pages);
+        return;
+    }
+    
+    const uint8_t *base = [self.machOFile bytes];
+    NSUInteger length = [self.machOFile.data length];
+    uint64_t preferredLoadAddress = self.machOFile.preferredLoadAddress;
+    dispatch_apply(runCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t run) {
+        NSUInteger end = MIN((run + 1) * pagesPerRun, pageCount);
+        for (NSUInteger index = run * pagesPerRun; index < end; index++) {
+            CDDecodeChainedFixupPage(&pages[index], base, length, preferredLoadAddress, &buffers[run]);
+        }
+    });
+    
+    NSUInteger total = 0;
+    for (NSUInteger run = 0; run < runCount; run++)
+        total += buffers[run].count;
+    
+    _fixups = malloc(MAX(total, 1) * sizeof(CDChainedFixup));
+    if (_fixups != NULL) {
+        for (NSUInteger run = 0; run < runCount; run++) {
+            memcpy(_fixups + _fixupCount, buffers[run].fixups, buffers[run].count * sizeof(CDChainedFixup));
+            _fixupCount += buffers[run].count;
+        }
+    }
+    
+    for (NSUInteger run = 0; run < runCount; run++)
+        free(buffers[run].fixups);
+    free(buffers);
+    free(pages);
+    
+    CDLogVerbose(@"Decoded %lu chained fixups in %lu pages", _fixupCount, pageCount);
+}
+
+#pragma mark - Debugging
+
+- (void)printFixups:(struct dyld_chained_fixups_header *)header {
+    uint8_t *fixup_base = (uint8_t *)header;
     printChainedFixupsHeader(header);
     [self printImports:header];
     struct dyld_chained_starts_in_image *starts_in_image =
     (struct dyld_chained_starts_in_image *)(fixup_base + header->starts_offset);
     
+    NSUInteger fixupCount = 0;
+    const CDChainedFixup *fixups = [self fixupsWithCount:&fixupCount];
+    NSUInteger fixupIndex = 0;
+    
     uint32_t *offsets = starts_in_image->seg_info_offset;
     for (int i = 0; i < starts_in_image->seg_count; ++i) {
         CDLCSegment *segCmd = self.machOFile.segments[i];
         //struct segment_command_64 *segCmd = machoBinary.segmentCommands[i];
-        if ([CDClassDump printFixupData]) {
-            fprintf(stderr,"  SEGMENT %.16s (offset: %d)\n", [segCmd.name UTF8String], offsets[i]);
-        }
+        fprintf(stderr,"  SEGMENT %.16s (offset: %d)\n", [segCmd.name UTF8String], offsets[i]);
         if (offsets[i] == 0) {
-            if ([CDClassDump printFixupData]) {
-                fprintf(stderr,"\n");
-            }
+            fprintf(stderr,"\n");
             continue;
         }
         
         struct dyld_chained_starts_in_segment* startsInSegment = (struct dyld_chained_starts_in_segment*)(fixup_base + header->starts_offset + offsets[i]);
         char formatted_pointer_format[256];
         formatPointerFormat(startsInSegment->pointer_format, formatted_pointer_format);
-        if ([CDClassDump printFixupData]){
-            fprintf(stderr,"    size: %d\n", startsInSegment->size);
-            fprintf(stderr,"    page_size: 0x%x\n", startsInSegment->page_size);
-            fprintf(stderr,"    pointer_format: %d (%s)\n", startsInSegment->pointer_format, formatted_pointer_format);
-            fprintf(stderr,"    segment_offset: 0x%llx\n", startsInSegment->segment_offset);
-            fprintf(stderr,"    max_valid_pointer: %d\n", startsInSegment->max_valid_pointer);
-            fprintf(stderr,"    page_count: %d\n", startsInSegment->page_count);
-            fprintf(stderr,"    page_start: %d\n", startsInSegment-> page_start[0]);
-        }
+        fprintf(stderr,"    size: %d\n", startsInSegment->size);
+        fprintf(stderr,"    page_size: 0x%x\n", startsInSegment->page_size);
+        fprintf(stderr,"    pointer_format: %d (%s)\n", startsInSegment->pointer_format, formatted_pointer_format);
+        fprintf(stderr,"    segment_offset: 0x%llx\n", startsInSegment->segment_offset);
+        fprintf(stderr,"    max_valid_pointer: %d\n", startsInSegment->max_valid_pointer);
+        fprintf(stderr,"    page_count: %d\n", startsInSegment->page_count);
+        fprintf(stderr,"    page_start: %d\n", startsInSegment-> page_start[0]);
         uint16_t *page_starts = startsInSegment->page_start;
-        uint16_t maxPageNum = UINT16_MAX;
-        int pageCount = 0;
-        for (int j = 0; j < MIN(startsInSegment->page_count, maxPageNum); ++j) {
-            if ([CDClassDump printFixupData]){
-                fprintf(stderr,"      PAGE %d (offset: %d)\n", j, page_starts[j]);
-            }
+        for (int j = 0; j < startsInSegment->page_count; ++j) {
+            fprintf(stderr,"      PAGE %d (offset: %d)\n", j, page_starts[j]);
             if (page_starts[j] == DYLD_CHAINED_PTR_START_NONE) { continue; }
             
-            [self processFixupsInPage:(uint8_t *)[self.machOFile bytes] fixupBase:fixup_base header:header startsIn:startsInSegment page:j];
+            if ((CDSupportedChainedPointerFormats & CDChainedPointerFormatBit(startsInSegment->pointer_format)) == 0) {
+                printf("Unsupported pointer format: 0x%x", startsInSegment->pointer_format);
+            }
             
-            pageCount++;
-            if ([CDClassDump printFixupData]){
-                fprintf(stderr,"\n");
+            for (; fixupIndex < fixupCount && fixups[fixupIndex].segmentIndex == i && fixups[fixupIndex].pageIndex == j; fixupIndex++) {
+                const CDChainedFixup *fixup = &fixups[fixupIndex];
+                if (fixup->kind == CDChainedFixupKindBind) {
+                    struct dyld_chained_ptr_64_bind bind = *(struct dyld_chained_ptr_64_bind *)&fixup->raw;
+                    NSString *symbol = [self symbolNameForImportOrdinal:(uint32_t)fixup->target];
+                    NSString *lib = symbol != nil ? _imports[symbol] : nil;
+                    fprintf(stderr,"        0x%08x RAW: %#010llx  BIND     ordinal: %d   addend: %d    dylib: %s   (%s)\n",
+                            (uint32_t)fixup->offset, _OSSwapInt64(fixup->raw), bind.ordinal, bind.addend, [lib UTF8String], [symbol UTF8String]);
+                } else {
+                    struct dyld_chained_ptr_64_rebase rebase = *(struct dyld_chained_ptr_64_rebase *)&fixup->raw;
+                    fprintf(stderr,"        %#010x RAW: %#010llx REBASE   target: %#010llx   high8: %#010x\n",
+                            (uint32_t)fixup->offset, fixup->raw, fixup->target, rebase.high8);
+                }
             }
-        }
-        if ([CDClassDump printFixupData]){
-            CDLog(@"symbolNamesByAddress: %@", _symbolNamesByAddress);
-            CDLog(@"based: %@", _based);
+            
+            fprintf(stderr,"\n");
         }
     }
 }
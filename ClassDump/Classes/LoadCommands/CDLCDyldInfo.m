@@ -10,6 +10,7 @@
 #import <ClassDump/ClassDumpUtils.h>
 #import <ClassDump/CDClassDump.h>
 #import <ClassDump/CDExtensions.h>
+#import <ClassDump/CDLogger.h>
 
 #ifdef DEBUG
 static BOOL debugBindOps = YES;
@@ -43,6 +44,27 @@ static NSString *CDBindTypeDescription(uint8_t type)
     return @"Unknown";
 }
 
+// One bind, packed.  The symbol index points into _bindSymbolNames.
+typedef struct {
+    uint64_t address;
+    uint32_t symbolIndex;
+} CDDyldBind;
+
+static int CDDyldBindCompare(const void *a, const void *b)
+{
+    const CDDyldBind *lhs = a, *rhs = b;
+    if (lhs->address < rhs->address) return -1;
+    if (lhs->address > rhs->address) return 1;
+    return 0;
+}
+
+// The rebase, lazy bind and export passes only log, so they only run when someone will see the output.
+static BOOL CDDyldInfoTracingEnabled(void)
+{
+    CDLogger *logger = [CDLogger sharedLogger];
+    return logger.isEnabled && logger.isVerbose;
+}
+
 @interface CDLCDyldInfo ()
 @end
 
@@ -55,7 +77,16 @@ static NSString *CDBindTypeDescription(uint8_t type)
     struct dyld_info_command _dyldInfoCommand;
     
     NSUInteger _ptrSize;
-    NSMutableDictionary<NSNumber *, NSString *> *_symbolNamesByAddress;
+    
+    // Binds are interpreted from the opcode streams on the first symbolNameForAddress:.
+    BOOL _bindsLoaded;
+    CDDyldBind *_binds;
+    NSUInteger _bindCount;
+    NSUInteger _bindCapacity;
+    NSMutableArray<NSString *> *_bindSymbolNames;
+    NSMapTable *_bindSymbolIndexes; // Symbol name pointer -> index + 1, only while loading
+    const char *_lastBindSymbol;
+    uint32_t _lastBindSymbolIndex;
 }
 
 - (instancetype)initWithDataCursor:(CDMachOFileDataCursor *)cursor;
@@ -90,26 +121,30 @@ static NSString *CDBindTypeDescription(uint8_t type)
 #endif
         
         _ptrSize = [[cursor machOFile] ptrSize];
-        
-        _symbolNamesByAddress = [[NSMutableDictionary alloc] init];
     }
 
     return self;
 }
 
+- (void)dealloc;
+{
+    free(_binds);
+}
+
 #pragma mark -
 
 - (void)machOFileDidReadLoadCommands:(CDMachOFile *)machOFile;
 {
-    
-    [self logRebaseInfo];
-    [self parseBindInfo];
-    [self parseWeakBindInfo];
-    [self logLazyBindInfo];
-    [self logExportedSymbols];
-    
-    
-    CDLogVerbose(@"symbolNamesByAddress: %@", _symbolNamesByAddress);
+    if (CDDyldInfoTracingEnabled()) {
+        [self logRebaseInfo];
+        [self logLazyBindInfo];
+        [self logExportedSymbols];
+    }
+}
+
+- (NSData *)opcodeDataAtOffset:(uint32_t)offset size:(uint32_t)size;
+{
+    return [self.machOFile dataViewAtOffset:offset length:size];
 }
 
 #pragma mark -
@@ -126,7 +161,42 @@ static NSString *CDBindTypeDescription(uint8_t type)
 
 - (NSString *)symbolNameForAddress:(NSUInteger)address;
 {
-    return [_symbolNamesByAddress objectForKey:[NSNumber numberWithUnsignedInteger:address]];
+    @synchronized (self) {
+        if (_bindsLoaded == NO) {
+            [self loadBinds];
+            _bindsLoaded = YES;
+        }
+    }
+
+    CDDyldBind key = { .address = address };
+    const CDDyldBind *bind = bsearch(&key, _binds, _bindCount, sizeof(CDDyldBind), CDDyldBindCompare);
+    return bind != NULL ? _bindSymbolNames[bind->symbolIndex] : nil;
+}
+
+- (void)loadBinds;
+{
+    _bindSymbolNames = [[NSMutableArray alloc] init];
+    _bindSymbolIndexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                               valueOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality];
+
+    [self parseBindInfo];
+    [self parseWeakBindInfo];
+
+    _bindSymbolIndexes = nil;
+    _lastBindSymbol = NULL;
+
+    // Stable, so that when an address is bound more than once the last bind wins, as it did with the dictionary.
+    mergesort(_binds, _bindCount, sizeof(CDDyldBind), CDDyldBindCompare);
+    NSUInteger uniqueCount = 0;
+    for (NSUInteger index = 0; index < _bindCount; index++) {
+        if (uniqueCount > 0 && _binds[uniqueCount - 1].address == _binds[index].address)
+            _binds[uniqueCount - 1] = _binds[index];
+        else
+            _binds[uniqueCount++] = _binds[index];
+    }
+    _bindCount = uniqueCount;
+
+    CDLogVerbose(@"Loaded %lu binds to %lu symbols", _bindCount, [_bindSymbolNames count]);
 }
 
 #pragma mark - Rebasing
@@ -146,8 +216,9 @@ static NSString *CDBindTypeDescription(uint8_t type)
 
     CDLogVerbose(@"----------------------------------------------------------------------");
     CDLogVerbose(@"rebase_off: %u, rebase_size: %u", _dyldInfoCommand.rebase_off, _dyldInfoCommand.rebase_size);
-    const uint8_t *start = (uint8_t *)[self.machOFile.data bytes] + _dyldInfoCommand.rebase_off;
-    const uint8_t *end = start + _dyldInfoCommand.rebase_size;
+    NSData *opcodes = [self opcodeDataAtOffset:_dyldInfoCommand.rebase_off size:_dyldInfoCommand.rebase_size];
+    const uint8_t *start = (const uint8_t *)[opcodes bytes];
+    const uint8_t *end = start + [opcodes length];
 
     CDLogVerbose(@"address: %016llx", address);
     const uint8_t *ptr = start;
@@ -266,8 +337,9 @@ static NSString *CDBindTypeDescription(uint8_t type)
         CDLogVerbose(@"----------------------------------------------------------------------");
         CDLogVerbose(@"bind_off: %u, bind_size: %u", _dyldInfoCommand.bind_off, _dyldInfoCommand.bind_size);
     }
-    const uint8_t *start = (uint8_t *)[self.machOFile.data bytes] + _dyldInfoCommand.bind_off;
-    const uint8_t *end = start + _dyldInfoCommand.bind_size;
+    NSData *opcodes = [self opcodeDataAtOffset:_dyldInfoCommand.bind_off size:_dyldInfoCommand.bind_size];
+    const uint8_t *start = (const uint8_t *)[opcodes bytes];
+    const uint8_t *end = start + [opcodes length];
 
     [self logBindOps:start end:end isLazy:NO];
 }
@@ -278,8 +350,9 @@ static NSString *CDBindTypeDescription(uint8_t type)
         CDLogVerbose(@"----------------------------------------------------------------------");
         CDLogVerbose(@"weak_bind_off: %u, weak_bind_size: %u", _dyldInfoCommand.weak_bind_off, _dyldInfoCommand.weak_bind_size);
     }
-    const uint8_t *start = (uint8_t *)[self.machOFile.data bytes] + _dyldInfoCommand.weak_bind_off;
-    const uint8_t *end = start + _dyldInfoCommand.weak_bind_size;
+    NSData *opcodes = [self opcodeDataAtOffset:_dyldInfoCommand.weak_bind_off size:_dyldInfoCommand.weak_bind_size];
+    const uint8_t *start = (const uint8_t *)[opcodes bytes];
+    const uint8_t *end = start + [opcodes length];
 
     [self logBindOps:start end:end isLazy:NO];
 }
@@ -290,8 +363,9 @@ static NSString *CDBindTypeDescription(uint8_t type)
         CDLogVerbose(@"----------------------------------------------------------------------");
         CDLogVerbose(@"lazy_bind_off: %u, lazy_bind_size: %u", _dyldInfoCommand.lazy_bind_off, _dyldInfoCommand.lazy_bind_size);
     }
-    const uint8_t *start = (uint8_t *)[self.machOFile.data bytes] + _dyldInfoCommand.lazy_bind_off;
-    const uint8_t *end = start + _dyldInfoCommand.lazy_bind_size;
+    NSData *opcodes = [self opcodeDataAtOffset:_dyldInfoCommand.lazy_bind_off size:_dyldInfoCommand.lazy_bind_size];
+    const uint8_t *start = (const uint8_t *)[opcodes bytes];
+    const uint8_t *end = start + [opcodes length];
 
     [self logBindOps:start end:end isLazy:YES];
 }
@@ -443,9 +517,34 @@ static NSString *CDBindTypeDescription(uint8_t type)
           address, type, flags, addend, libraryOrdinal, symbolName);
 #endif
 
-    NSNumber *key = [NSNumber numberWithUnsignedInteger:address]; // I don't think 32-bit will dump 64-bit stuff.
-    NSString *str = [[NSString alloc] initWithUTF8String:symbolName];
-    _symbolNamesByAddress[key] = str;
+    // Only the bind and weak bind streams are recorded, and only while loadBinds is running.
+    if (_bindSymbolIndexes == nil || symbolName == NULL)
+        return;
+
+    // Runs of binds share one symbol, so remember the last one before going to the map.
+    if (symbolName != _lastBindSymbol) {
+        uintptr_t index = (uintptr_t)NSMapGet(_bindSymbolIndexes, symbolName);
+        if (index == 0) {
+            NSString *str = [[NSString alloc] initWithUTF8String:symbolName];
+            if (str == nil)
+                return;
+            [_bindSymbolNames addObject:str];
+            index = [_bindSymbolNames count];
+            NSMapInsert(_bindSymbolIndexes, symbolName, (const void *)index);
+        }
+        _lastBindSymbol = symbolName;
+        _lastBindSymbolIndex = (uint32_t)(index - 1);
+    }
+
+    if (_bindCount == _bindCapacity) {
+        _bindCapacity = MAX(_bindCapacity * 2, 256);
+        _binds = reallocf(_binds, _bindCapacity * sizeof(CDDyldBind));
+        if (_binds == NULL) {
+            _bindCount = _bindCapacity = 0;
+            return;
+        }
+    }
+    _binds[_bindCount++] = (CDDyldBind){ .address = address, .symbolIndex = _lastBindSymbolIndex };
 }
 
 #pragma mark - Exported symbols
@@ -458,8 +557,11 @@ static NSString *CDBindTypeDescription(uint8_t type)
         CDLogVerbose(@"hexdump -Cv -s %u -n %u", _dyldInfoCommand.export_off, _dyldInfoCommand.export_size);
     }
 
-    const uint8_t *start = (uint8_t *)[self.machOFile.data bytes] + _dyldInfoCommand.export_off;
-    const uint8_t *end = start + _dyldInfoCommand.export_size;
+    NSData *exportData = [self opcodeDataAtOffset:_dyldInfoCommand.export_off size:_dyldInfoCommand.export_size];
+    const uint8_t *start = (const uint8_t *)[exportData bytes];
+    const uint8_t *end = start + [exportData length];
+    if (start == end)
+        return;
 
     CDLogVerbose(@"         Type Flags Offset           Name");
     CDLogVerbose(@"------------- ----- ---------------- ----");
@@ -10,11 +10,22 @@
 #import <ClassDump/CDRelocationInfo.h>
 #import <ClassDump/ClassDumpUtils.h>
 
+// Open addressing, slots hold entry index + 1 so that zero means empty.
+static inline NSUInteger CDRelocationHashSlot(uint32_t offset, NSUInteger mask)
+{
+    return (NSUInteger)((offset * 0x9E3779B1u) >> 7) & mask;
+}
+
 @implementation CDLCDynamicSymbolTable
 {
     struct dysymtab_command _dysymtab;
     
-    NSArray<CDRelocationInfo *> *_externalRelocationEntries;
+    struct relocation_info *_externalRelocationEntries;
+    uint32_t _externalRelocationCount;
+
+    // Keyed by r_address, extern entries only.
+    uint32_t *_relocationSlots;
+    NSUInteger _relocationSlotMask;
 }
 
 - (instancetype)initWithDataCursor:(CDMachOFileDataCursor *)cursor;
@@ -64,13 +75,17 @@
         CDLogVerbose(@"locreloff:      0x%08x  %d", dysymtab.locreloff, dysymtab.locreloff);
         CDLogVerbose(@"nlocrel:        0x%08x  %d", dysymtab.nlocrel, dysymtab.nlocrel);
 #endif
-        
-        _externalRelocationEntries = [[NSMutableArray alloc] init];
     }
 
     return self;
 }
 
+- (void)dealloc;
+{
+    free(_externalRelocationEntries);
+    free(_relocationSlots);
+}
+
 #pragma mark -
 
 - (uint32_t)cmd;
@@ -85,7 +100,14 @@
 
 - (void)loadSymbols;
 {
-    NSMutableArray *externalRelocationEntries = [[NSMutableArray alloc] init];
+    free(_externalRelocationEntries);
+    free(_relocationSlots);
+    _externalRelocationEntries = calloc(MAX(_dysymtab.nextrel, 1), sizeof(struct relocation_info));
+    _externalRelocationCount = 0;
+    _relocationSlots = NULL;
+    _relocationSlotMask = 0;
+    if (_externalRelocationEntries == NULL)
+        return;
     
     CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile offset:_dysymtab.extreloff];
 
@@ -120,8 +142,7 @@
         CDLogVerbose(@"%3d: %08x  %08x   %08x      %01x    %01x    %01x     %01x", index, rinfo.r_address, val,
               rinfo.r_symbolnum, rinfo.r_pcrel, rinfo.r_length, rinfo.r_extern, rinfo.r_type);
 
-        CDRelocationInfo *ri = [[CDRelocationInfo alloc] initWithInfo:rinfo];
-        [externalRelocationEntries addObject:ri];
+        _externalRelocationEntries[_externalRelocationCount++] = rinfo;
     }
 
     //CDLogVerbose(@"externalRelocationEntries: %@", externalRelocationEntries);
@@ -134,16 +155,49 @@
     // 0000000000000000 01 00 0500 0000000000000038 _OBJC_CLASS_$_NSObject
     // GET_LIBRARY_ORDINAL() from nlist.h for library.
     
-    _externalRelocationEntries = [externalRelocationEntries copy];
+    [self _buildRelocationIndex];
+}
+
+- (void)_buildRelocationIndex;
+{
+    NSUInteger capacity = 16;
+    while (capacity < (NSUInteger)_externalRelocationCount * 2)
+        capacity <<= 1;
+
+    _relocationSlots = calloc(capacity, sizeof(uint32_t));
+    if (_relocationSlots == NULL)
+        return;
+    _relocationSlotMask = capacity - 1;
+
+    for (uint32_t index = 0; index < _externalRelocationCount; index++) {
+        const struct relocation_info *rinfo = &_externalRelocationEntries[index];
+        if (rinfo->r_extern == 0)
+            continue;
+
+        // The first entry for an offset wins, as it did when this was a linear search.
+        NSUInteger slot = CDRelocationHashSlot((uint32_t)rinfo->r_address, _relocationSlotMask);
+        while (_relocationSlots[slot] != 0) {
+            if (_externalRelocationEntries[_relocationSlots[slot] - 1].r_address == rinfo->r_address)
+                break;
+            slot = (slot + 1) & _relocationSlotMask;
+        }
+        if (_relocationSlots[slot] == 0)
+            _relocationSlots[slot] = index + 1;
+    }
 }
 
 // Just search for externals.
 - (CDRelocationInfo *)relocationEntryWithOffset:(NSUInteger)offset;
 {
-    for (CDRelocationInfo *info in _externalRelocationEntries) {
-        if (info.isExtern && info.offset == offset) {
-            return info;
-        }
+    if (_relocationSlots == NULL || offset > UINT32_MAX)
+        return nil;
+
+    NSUInteger slot = CDRelocationHashSlot((uint32_t)offset, _relocationSlotMask);
+    while (_relocationSlots[slot] != 0) {
+        const struct relocation_info *rinfo = &_externalRelocationEntries[_relocationSlots[slot] - 1];
+        if ((uint32_t)rinfo->r_address == (uint32_t)offset)
+            return [[CDRelocationInfo alloc] initWithInfo:*rinfo];
+        slot = (slot + 1) & _relocationSlotMask;
     }
 
     return nil;
@@ -10,7 +10,10 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @interface CDLCExportTRIEData : CDLoadCommand
+// Walks only the edges matching symbol.  Returns 0 if it isn't exported, or isn't a regular export.
 - (uint64_t)getExportedSymbolLocation:(NSString *)symbol;
+// Streams every terminal in the trie; nothing is kept once the block returns.
+- (void)enumerateExportedSymbolsUsingBlock:(void (NS_NOESCAPE ^)(NSString *symbol, uint64_t flags, uint64_t symbolOffset, BOOL *stop))block;
 @end
 
 NS_ASSUME_NONNULL_END
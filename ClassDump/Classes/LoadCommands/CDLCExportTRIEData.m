@@ -13,20 +13,35 @@
 #import <ClassDump/ClassDumpUtils.h>
 #import <ClassDump/CDClassDump.h>
 #import <ClassDump/CDExtensions.h>
-#ifdef DEBUG
-//static BOOL debugBindOps = YES;
-static BOOL debugExportedSymbols = YES;
-#else
-//static BOOL debugBindOps = NO;
-static BOOL debugExportedSymbols = NO;
-#endif
+#import <ClassDump/CDLogger.h>
 
+// Deep enough for any real symbol, and keeps a malformed (cyclic) trie from running away.
+static const NSUInteger CDExportTrieMaxDepth = 4096;
+
+// Reads a uleb128, refusing to run past end.
+static BOOL CDExportTrieReadULEB(const uint8_t **ptr, const uint8_t *end, uint64_t *value)
+{
+    const uint8_t *p = *ptr;
+    uint64_t result = 0;
+    unsigned bit = 0;
+    while (p < end) {
+        uint8_t byte = *p++;
+        if (bit < 64)
+            result |= (uint64_t)(byte & 0x7f) << bit;
+        bit += 7;
+        if ((byte & 0x80) == 0) {
+            *ptr = p;
+            *value = result;
+            return YES;
+        }
+    }
+    return NO;
+}
 
 @implementation CDLCExportTRIEData
 {
     struct linkedit_data_command _linkeditDataCommand;
     NSData *_linkeditData;
-    NSMutableDictionary *_symbolData;
 }
 
 - (instancetype)initWithDataCursor:(CDMachOFileDataCursor *)cursor;
@@ -37,7 +52,6 @@ static BOOL debugExportedSymbols = NO;
         
         _linkeditDataCommand.dataoff  = [cursor readInt32];
         _linkeditDataCommand.datasize = [cursor readInt32];
-        _symbolData = [NSMutableDictionary new];
     }
 
     return self;
@@ -58,7 +72,7 @@ static BOOL debugExportedSymbols = NO;
 - (NSData *)linkeditData;
 {
     if (_linkeditData == NULL) {
-        _linkeditData = [[NSData alloc] initWithBytes:[self.machOFile bytesAtOffset:_linkeditDataCommand.dataoff] length:_linkeditDataCommand.datasize];
+        _linkeditData = [self.machOFile dataViewAtOffset:_linkeditDataCommand.dataoff length:_linkeditDataCommand.datasize];
     }
     
     return _linkeditData;
@@ -66,80 +80,202 @@ static BOOL debugExportedSymbols = NO;
 
 - (void)machOFileDidReadLoadCommands:(CDMachOFile *)machOFile;
 {
-    [self logExportedSymbols];
-    CDLogInfo(@"_symbolData: %@", _symbolData);
+    // Nothing is read up front; the listing is only produced if someone is going to see it.
+    CDLogger *logger = [CDLogger sharedLogger];
+    if (logger.isEnabled && logger.isVerbose) {
+        [self logExportedSymbols];
+    }
 }
 
 - (void)logExportedSymbols;
 {
-    if (debugExportedSymbols) {
-        CDLogInfo(@"----------------------------------------------------------------------");
-        CDLogInfo(@"export_off: %u, export_size: %u", _linkeditDataCommand.dataoff, _linkeditDataCommand.datasize);
-        CDLogInfo(@"hexdump -Cv -s %u -n %u", _linkeditDataCommand.dataoff, _linkeditDataCommand.datasize);
-    }
-
-    const uint8_t *start = (uint8_t *)[self.machOFile.data bytes] + _linkeditDataCommand.dataoff;
-    const uint8_t *end = start + _linkeditDataCommand.datasize;
-
+    CDLogInfo(@"----------------------------------------------------------------------");
+    CDLogInfo(@"export_off: %u, export_size: %u", _linkeditDataCommand.dataoff, _linkeditDataCommand.datasize);
+    CDLogInfo(@"hexdump -Cv -s %u -n %u", _linkeditDataCommand.dataoff, _linkeditDataCommand.datasize);
     CDLogInfo(@"         Type Flags Offset           Name");
     CDLogInfo(@"------------- ----- ---------------- ----");
-    [self printSymbols:start end:end prefix:@"" offset:0];
-}
-
-- (void)printSymbols:(const uint8_t *)start end:(const uint8_t *)end prefix:(NSString *)prefix offset:(uint64_t)offset;
-{
-    CDLogVerbose(@" > %s, %p-%p, offset: %lx = %p", __PRETTY_FUNCTION__, start, end, offset, start + offset);
-
-    const uint8_t *ptr = start + offset;
-    NSParameterAssert(ptr < end);
-
-    uint8_t terminalSize = *ptr++;
-    const uint8_t *tptr = ptr;
-    CDLogVerbose(@"terminalSize: %u", terminalSize);
-
-    ptr += terminalSize;
-
-    uint8_t childCount = *ptr++;
-
-    if (terminalSize > 0) {
-        //CDLogVerbose(@"symbol: '%@', terminalSize: %u", prefix, terminalSize);
-        uint64_t flags = read_uleb128(&tptr, end);
+    [self enumerateExportedSymbolsUsingBlock:^(NSString *symbol, uint64_t flags, uint64_t symbolOffset, BOOL *stop) {
         uint8_t kind = flags & EXPORT_SYMBOL_FLAGS_KIND_MASK;
         if (kind == EXPORT_SYMBOL_FLAGS_KIND_REGULAR) {
-            uint64_t symbolOffset = read_uleb128(&tptr, end);
-            CDLogInfo(@"     Regular: %04llx  %016llx %@", flags, symbolOffset, prefix);
-            //CDLogVerbose(@"     Regular: %04x  0x%08x %@", flags, symbolOffset, prefix);
-            NSDictionary *_symbol = @{@"type": @"Regular",
-                                      @"flags": [NSNumber numberWithUnsignedInteger:flags],
-                                      @"symbolOffset": [NSNumber numberWithUnsignedInteger:symbolOffset],
-                                      @"symbol": prefix};
-            _symbolData[prefix] = _symbol;
+            CDLogInfo(@"     Regular: %04llx  %016llx %@", flags, symbolOffset, symbol);
         } else if (kind == EXPORT_SYMBOL_FLAGS_KIND_THREAD_LOCAL) {
-            CDLogInfo(@"Thread Local: %04llx                   %@, terminalSize: %u", flags, prefix, terminalSize);
+            CDLogInfo(@"Thread Local: %04llx                   %@", flags, symbol);
         } else {
-            CDLogInfo(@"     Unknown: %04llx  %x, name: %@, terminalSize: %u", flags, kind, prefix, terminalSize);
+            CDLogInfo(@"     Unknown: %04llx  %x, name: %@", flags, kind, symbol);
         }
-    }
-
-    for (uint8_t index = 0; index < childCount; index++) {
-        const uint8_t *edgeStart = ptr;
+    }];
+}
 
-        while (*ptr++ != 0)
-            ;
+#pragma mark - Trie
 
-        NSUInteger length = ptr - edgeStart;
-        CDLogVerbose(@"edge length: %u, edge: '%s'", length, edgeStart);
-        uint64_t nodeOffset = read_uleb128(&ptr, end);
-        CDLogVerbose(@"node offset: %lx", nodeOffset);
+// Each node: uleb128 terminal size, terminal info (uleb128 flags, uleb128 offset, ...), uint8 child count,
+// then per child a NUL terminated edge label and a uleb128 node offset.
 
-        [self printSymbols:start end:end prefix:[NSString stringWithFormat:@"%@%s", prefix, edgeStart] offset:nodeOffset];
+- (uint64_t)getExportedSymbolLocation:(NSString *)symbol {
+    NSData *exportData = [self linkeditData];
+    const uint8_t *start = (const uint8_t *)[exportData bytes];
+    const uint8_t *end = start + [exportData length];
+    const char *name = [symbol UTF8String];
+    if (start == end || name == NULL)
+        return 0;
+    
+    const uint8_t *node = start;
+    for (NSUInteger depth = 0; depth < CDExportTrieMaxDepth; depth++) {
+        const uint8_t *ptr = node;
+        uint64_t terminalSize;
+        if (!CDExportTrieReadULEB(&ptr, end, &terminalSize) || terminalSize > (uint64_t)(end - ptr))
+            return 0;
+        
+        if (*name == '\0') {
+            // Ran out of name, so this node is the symbol, if it's a terminal at all.
+            uint64_t flags, symbolOffset;
+            if (terminalSize == 0
+                || !CDExportTrieReadULEB(&ptr, end, &flags)
+                || (flags & EXPORT_SYMBOL_FLAGS_KIND_MASK) != EXPORT_SYMBOL_FLAGS_KIND_REGULAR
+                || (flags & EXPORT_SYMBOL_FLAGS_REEXPORT) != 0
+                || !CDExportTrieReadULEB(&ptr, end, &symbolOffset))
+                return 0;
+            return symbolOffset;
+        }
+        
+        ptr += terminalSize;
+        if (ptr >= end)
+            return 0;
+        uint8_t childCount = *ptr++;
+        
+        const uint8_t *next = NULL;
+        for (uint8_t index = 0; index < childCount && next == NULL; index++) {
+            // Compare the edge label against the rest of the name as we go.
+            const char *n = name;
+            BOOL matches = YES;
+            while (ptr < end && *ptr != 0) {
+                if (matches && *n == (char)*ptr)
+                    n++;
+                else
+                    matches = NO;
+                ptr++;
+            }
+            if (ptr >= end)
+                return 0;
+            ptr++; // Skip the NUL
+            
+            uint64_t childOffset;
+            if (!CDExportTrieReadULEB(&ptr, end, &childOffset) || childOffset >= (uint64_t)(end - start))
+                return 0;
+            
+            if (matches) {
+                name = n;
+                next = start + childOffset;
+            }
+        }
+        
+        if (next == NULL)
+            return 0;
+        node = next;
     }
-
-    CDLogVerbose(@"<  %s, %p-%p, offset: %lx = %p", __PRETTY_FUNCTION__, start, end, offset, start + offset);
+    
+    return 0;
 }
 
-- (uint64_t)getExportedSymbolLocation:(NSString *)symbol {
-    return [_symbolData[symbol][@"symbolOffset"] unsignedIntegerValue];
+- (void)enumerateExportedSymbolsUsingBlock:(void (NS_NOESCAPE ^)(NSString *symbol, uint64_t flags, uint64_t symbolOffset, BOOL *stop))block {
+    NSData *exportData = [self linkeditData];
+    const uint8_t *start = (const uint8_t *)[exportData bytes];
+    const uint8_t *end = start + [exportData length];
+    if (start == end)
+        return;
+    
+    // Depth first with an explicit stack.  Each frame is a node whose children are being walked; the name is
+    // built up in one buffer, truncated back to the frame's length before each edge is appended.
+    typedef struct {
+        const uint8_t *nextChild;
+        uint8_t remainingChildren;
+        NSUInteger nameLength;
+    } CDExportTrieFrame;
+    
+    CDExportTrieFrame *frames = malloc(CDExportTrieMaxDepth * sizeof(CDExportTrieFrame));
+    NSUInteger nameCapacity = 256;
+    char *name = malloc(nameCapacity);
+    if (frames == NULL || name == NULL) {
+        free(frames);
+        free(name);
+        return;
+    }
+    
+    NSUInteger depth = 0;
+    NSUInteger nameLength = 0;
+    NSUInteger visited = 0;
+    const uint8_t *node = start;
+    BOOL stop = NO;
+    
+    while (stop == NO) {
+        if (node != NULL) {
+            // Visit the node: report it if it's a terminal, then push it so its children get walked.
+            const uint8_t *ptr = node;
+            node = NULL;
+            uint64_t terminalSize;
+            if (++visited > [exportData length]
+                || !CDExportTrieReadULEB(&ptr, end, &terminalSize)
+                || terminalSize >= (uint64_t)(end - ptr))
+                break; // Malformed, or a cycle: there can't be more nodes than bytes.
+            
+            if (terminalSize > 0) {
+                const uint8_t *tptr = ptr;
+                uint64_t flags = 0, symbolOffset = 0;
+                if (CDExportTrieReadULEB(&tptr, ptr + terminalSize, &flags)) {
+                    if ((flags & EXPORT_SYMBOL_FLAGS_REEXPORT) == 0)
+                        CDExportTrieReadULEB(&tptr, ptr + terminalSize, &symbolOffset);
+                    NSString *symbol = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSUTF8StringEncoding];
+                    if (symbol != nil)
+                        block(symbol, flags, symbolOffset, &stop);
+                }
+            }
+            
+            ptr += terminalSize;
+            if (depth == CDExportTrieMaxDepth)
+                break;
+            frames[depth++] = (CDExportTrieFrame){ .nextChild = ptr + 1, .remainingChildren = *ptr, .nameLength = nameLength };
+            continue;
+        }
+        
+        if (depth == 0)
+            break;
+        
+        CDExportTrieFrame *frame = &frames[depth - 1];
+        if (frame->remainingChildren == 0) {
+            depth--;
+            continue;
+        }
+        
+        // Next edge of the top frame.
+        const uint8_t *ptr = frame->nextChild;
+        const uint8_t *edgeStart = ptr;
+        while (ptr < end && *ptr != 0)
+            ptr++;
+        if (ptr >= end)
+            break;
+        NSUInteger edgeLength = ptr - edgeStart;
+        ptr++;
+        
+        uint64_t childOffset;
+        if (!CDExportTrieReadULEB(&ptr, end, &childOffset) || childOffset >= (uint64_t)(end - start))
+            break;
+        frame->nextChild = ptr;
+        frame->remainingChildren--;
+        
+        nameLength = frame->nameLength;
+        if (nameLength + edgeLength > nameCapacity) {
+            nameCapacity = MAX(nameCapacity * 2, nameLength + edgeLength);
+            name = reallocf(name, nameCapacity);
+            if (name == NULL)
+                break;
+        }
+        memcpy(name + nameLength, edgeStart, edgeLength);
+        nameLength += edgeLength;
+        node = start + childOffset;
+    }
+    
+    free(frames);
+    free(name);
 }
 
 @end
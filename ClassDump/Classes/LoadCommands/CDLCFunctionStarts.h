@@ -8,6 +8,17 @@
 
 @interface CDLCFunctionStarts : CDLCLinkeditData
 
+// Offsets from the start of __TEXT, boxed the first time they're asked for.  Prefer the packed table below.
 @property (nonatomic, readonly) NSArray *functionStarts;
 
+// Sorted function start addresses, decoded once when the load commands have been read.
+@property (nonatomic, readonly) NSUInteger functionCount;
+- (const uint64_t *)functionAddresses NS_RETURNS_INNER_POINTER;
+
+// These return 0 when there's no answer.
+- (uint64_t)functionContainingAddress:(uint64_t)address;
+- (uint64_t)functionAfterAddress:(uint64_t)address;
+// Distance to the next function start, or to the end of the section for the last function.
+- (uint64_t)sizeOfFunctionAtAddress:(uint64_t)address;
+
 @end
@@ -5,31 +5,125 @@
 
 #import <ClassDump/CDLCFunctionStarts.h>
 
-#import <ClassDump/ULEB128.h>
+#import <ClassDump/CDMachOFile.h>
+#import <ClassDump/CDLCSegment.h>
+#import <ClassDump/CDSection.h>
+#import <ClassDump/CDAddressIndex.h>
 #import <ClassDump/ClassDumpUtils.h>
+
 @implementation CDLCFunctionStarts
 {
+    uint64_t *_functionAddresses;
+    NSUInteger _functionCount;
     NSArray *_functionStarts;
 }
 
+- (void)dealloc;
+{
+    free(_functionAddresses);
+}
+
 #pragma mark -
 
+// The table is a run of uleb128 deltas, the first relative to the start of __TEXT, terminated by a zero delta.
+- (void)machOFileDidReadLoadCommands:(CDMachOFile *)machOFile;
+{
+    NSData *functionStartsData = [self linkeditData];
+    const uint8_t *ptr = (const uint8_t *)[functionStartsData bytes];
+    const uint8_t *end = ptr + [functionStartsData length];
+    uint64_t address = [[machOFile segmentWithName:@"__TEXT"] vmaddr];
+
+    // Every function takes at least one byte of the table, so this is enough.
+    _functionAddresses = malloc(MAX([functionStartsData length], 1) * sizeof(uint64_t));
+    if (_functionAddresses == NULL)
+        return;
+
+    while (ptr < end) {
+        uint64_t delta = 0;
+        unsigned bit = 0;
+        uint8_t byte;
+        do {
+            byte = *ptr++;
+            if (bit < 64)
+                delta |= (uint64_t)(byte & 0x7f) << bit;
+            bit += 7;
+        } while ((byte & 0x80) != 0 && ptr < end);
+
+        if (delta == 0)
+            break;
+        address += delta;
+        _functionAddresses[_functionCount++] = address;
+    }
+}
+
 - (NSArray *)functionStarts;
 {
-    if (_functionStarts == nil) {
-        NSData *functionStartsData = [self linkeditData];
-        const uint8_t *start = (uint8_t *)[functionStartsData bytes];
-        const uint8_t *end = start + [functionStartsData length];
-        uint64_t startAddress;
-        uint64_t previousAddress = 0;
-        NSMutableArray *functionStarts = [[NSMutableArray alloc] init];
-        while ((startAddress = read_uleb128(&start, end))) {
-            [functionStarts addObject:@(startAddress + previousAddress)];
-            previousAddress += startAddress;
+    @synchronized (self) {
+        if (_functionStarts == nil) {
+            uint64_t textAddress = [[self.machOFile segmentWithName:@"__TEXT"] vmaddr];
+            NSMutableArray *functionStarts = [[NSMutableArray alloc] initWithCapacity:_functionCount];
+            for (NSUInteger index = 0; index < _functionCount; index++)
+                [functionStarts addObject:@(_functionAddresses[index] - textAddress)];
+            _functionStarts = [functionStarts copy];
         }
-        _functionStarts = [functionStarts copy];
     }
+
     return _functionStarts;
 }
 
+- (NSUInteger)functionCount;
+{
+    return _functionCount;
+}
+
+- (const uint64_t *)functionAddresses;
+{
+    return _functionAddresses;
+}
+
+#pragma mark - Queries
+
+// Index of the last function starting at or before address, or NSNotFound.
+- (NSUInteger)indexOfFunctionContainingAddress:(uint64_t)address;
+{
+    NSUInteger low = 0, high = _functionCount;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (_functionAddresses[mid] <= address)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low > 0 ? low - 1 : NSNotFound;
+}
+
+- (uint64_t)functionContainingAddress:(uint64_t)address;
+{
+    NSUInteger index = [self indexOfFunctionContainingAddress:address];
+    return index != NSNotFound ? _functionAddresses[index] : 0;
+}
+
+- (uint64_t)functionAfterAddress:(uint64_t)address;
+{
+    NSUInteger index = [self indexOfFunctionContainingAddress:address];
+    NSUInteger next = (index == NSNotFound) ? 0 : index + 1;
+    return next < _functionCount ? _functionAddresses[next] : 0;
+}
+
+- (uint64_t)sizeOfFunctionAtAddress:(uint64_t)address;
+{
+    NSUInteger index = [self indexOfFunctionContainingAddress:address];
+    if (index == NSNotFound || _functionAddresses[index] != address)
+        return 0;
+
+    // The last function in a section runs to the end of that section, not to the first function of the next one.
+    CDSection *section = [self.machOFile.addressIndex sectionContainingAddress:address];
+    uint64_t end = section != nil ? section.addr + section.size : 0;
+    if (index + 1 < _functionCount && (end == 0 || _functionAddresses[index + 1] < end))
+        end = _functionAddresses[index + 1];
+
+    return end > address ? end - address : 0;
+}
+
 @end
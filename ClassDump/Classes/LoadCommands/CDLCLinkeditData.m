@@ -41,7 +41,7 @@
 - (NSData *)linkeditData;
 {
     if (_linkeditData == NULL) {
-        _linkeditData = [[NSData alloc] initWithBytes:[self.machOFile bytesAtOffset:_linkeditDataCommand.dataoff] length:_linkeditDataCommand.datasize];
+        _linkeditData = [self.machOFile dataViewAtOffset:_linkeditDataCommand.dataoff length:_linkeditDataCommand.datasize];
     }
     
     return _linkeditData;
@@ -27,6 +27,7 @@ extern NSString *CDSegmentEncryptionTypeName(CDSegmentEncryptionType type);
 @property (strong) NSArray<CDSection *> *sections;
 
 @property (nonatomic, readonly) NSUInteger vmaddr;
+@property (nonatomic, readonly) NSUInteger vmsize;
 @property (nonatomic, readonly) NSUInteger fileoff;
 @property (nonatomic, readonly) NSUInteger filesize;
 @property (nonatomic, readonly) vm_prot_t initprot;
@@ -6,6 +6,7 @@
 #import <ClassDump/CDLCSegment.h>
 #import <ClassDump/CDMachOFile.h>
 #import <ClassDump/CDSection.h>
+#import <ClassDump/CDAddressIndex.h>
 #include <mach-o/arch.h>
 #include <CommonCrypto/CommonCrypto.h>
 #include <ClassDump/blowfish.h>
@@ -54,6 +55,7 @@ NSString *CDSegmentEncryptionTypeName(CDSegmentEncryptionType type)
     
     NSString *_name;
     NSArray<CDSection *> *_sections;
+    NSDictionary<NSString *, CDSection *> *_sectionsByName;
     
     NSMutableData *_decryptedData;
 }
@@ -85,7 +87,7 @@ NSString *CDSegmentEncryptionTypeName(CDSegmentEncryptionType type)
                 //CDLog(@"section at index: %lu of %lu was nil", index, _segmentCommand.nsects);
             }
         }
-        _sections = [sections copy];
+        self.sections = sections;
     }
 
     return self;
@@ -118,6 +120,11 @@ NSString *CDSegmentEncryptionTypeName(CDSegmentEncryptionType type)
     return _segmentCommand.vmaddr;
 }
 
+- (NSUInteger)vmsize;
+{
+    return _segmentCommand.vmsize;
+}
+
 - (NSUInteger)fileoff;
 {
     return _segmentCommand.fileoff;
@@ -205,27 +212,31 @@ NSString *CDSegmentEncryptionTypeName(CDSegmentEncryptionType type)
 
 - (CDSection *)sectionContainingAddress:(NSUInteger)address;
 {
-    for (CDSection *section in self.sections) {
-        if ([section containsAddress:address])
-            return section;
-    }
+    if ([self containsAddress:address] == NO)
+        return nil;
 
-    return nil;
+    return [self.machOFile.addressIndex sectionContainingAddress:address];
 }
 
-- (CDSection *)sectionWithName:(NSString *)name;
+- (void)setSections:(NSArray<CDSection *> *)sections;
 {
-    for (CDSection *section in self.sections) {
-        if ([[section sectionName] isEqual:name])
-            return section;
+    _sections = [sections copy];
+
+    NSMutableDictionary *sectionsByName = [[NSMutableDictionary alloc] init];
+    for (CDSection *section in _sections) {
+        if (section.sectionName != nil && sectionsByName[section.sectionName] == nil)
+            sectionsByName[section.sectionName] = section; // First one wins, same as the old linear scan
     }
+    _sectionsByName = [sectionsByName copy];
+}
 
-    return nil;
+- (CDSection *)sectionWithName:(NSString *)name;
+{
+    return _sectionsByName[name];
 }
 
 - (NSUInteger)fileOffsetForAddress:(NSUInteger)address;
 {
-    
     CDSection *section = [self sectionContainingAddress:address];
     CDLogVerbose(@"section: %@ address: 0x%08lx", section, address);
     return [section fileOffsetForAddress:address];
@@ -8,6 +8,8 @@
 
 @class CDSymbol;
 
+// The nlist entries and string table stay in the file.  -loadSymbols only indexes the _OBJC_CLASS_$_ symbols,
+// CDSymbol objects are created the first time they're asked for.
 @interface CDLCSymbolTable : CDLoadCommand
 
 - (void)loadSymbols;
@@ -18,7 +20,11 @@
 @property (nonatomic, readonly) uint32_t strsize;
 
 @property (nonatomic, readonly) NSUInteger baseAddress;
+// Materializes every symbol, avoid on large tables.
 @property (nonatomic, readonly) NSArray<CDSymbol *> *symbols;
+@property (nonatomic, readonly) NSUInteger symbolCount;
+
+- (CDSymbol *)symbolAtIndex:(NSUInteger)index;
 
 - (CDSymbol *)symbolForClassName:(NSString *)className;
 - (CDSymbol *)symbolForExternalClassName:(NSString *)className;
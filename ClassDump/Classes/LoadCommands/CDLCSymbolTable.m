@@ -6,22 +6,69 @@
 #import <ClassDump/CDLCSymbolTable.h>
 
 #include <mach-o/nlist.h>
+#include <libkern/OSByteOrder.h>
 #import <ClassDump/CDMachOFile.h>
 #import <ClassDump/CDSymbol.h>
 #import <ClassDump/CDLCSegment.h>
 #import <ClassDump/CDLCDylib.h>
 #import <ClassDump/ClassDumpUtils.h>
+#import <ClassDump/CDLogger.h>
 //#define VERBOSE_TABLES
 
+static const char CDClassSymbolPrefix[] = "_OBJC_CLASS_$_";
+static const size_t CDClassSymbolPrefixLength = sizeof(CDClassSymbolPrefix) - 1;
+static const size_t CDClassSymbolPrefixDollarIndex = 12;
+
+// Marks every string table offset that starts with _OBJC_CLASS_$_.  '$' is rare in C and ObjC symbol names, so memchr()
+// (vectorized in libc) skips most of the table and only the candidates it lands on get compared.
+static uint8_t *CDMarkClassSymbolPrefixes(const char *strtab, size_t length, NSUInteger *matchCount)
+{
+    uint8_t *bitmap = calloc((length + 7) / 8 + 1, 1);
+    if (bitmap == NULL)
+        return NULL;
+
+    NSUInteger count = 0;
+    const char *ptr = strtab + CDClassSymbolPrefixDollarIndex;
+    const char *end = strtab + length;
+    while (ptr < end && (ptr = memchr(ptr, '$', (size_t)(end - ptr))) != NULL) {
+        const char *candidate = ptr - CDClassSymbolPrefixDollarIndex;
+        if ((size_t)(end - candidate) >= CDClassSymbolPrefixLength && memcmp(candidate, CDClassSymbolPrefix, CDClassSymbolPrefixLength) == 0) {
+            size_t offset = (size_t)(candidate - strtab);
+            bitmap[offset / 8] |= (uint8_t)(1 << (offset % 8));
+            count++;
+        }
+        ptr++;
+    }
+
+    *matchCount = count;
+    return bitmap;
+}
+
+static BOOL CDSymbolTableTracingEnabled(void)
+{
+    CDLogger *logger = [CDLogger sharedLogger];
+    return logger.isEnabled && logger.isVerbose;
+}
+
 @implementation CDLCSymbolTable
 {
     struct symtab_command _symtabCommand;
     
-    NSArray<CDSymbol *> *_symbols;
     NSUInteger _baseAddress;
-    
-    NSDictionary<NSString *, CDSymbol *> *_classSymbols;
-    NSDictionary<NSString *, CDSymbol *> *_externalClassSymbols;
+
+    // Views of the file, nothing is copied.
+    NSData *_nlistData;
+    NSData *_stringTable;
+    NSUInteger _symbolCount;
+    BOOL _is64Bit;
+    BOOL _isBigEndian;
+
+    NSMutableDictionary<NSNumber *, CDSymbol *> *_materializedSymbols;
+    NSArray<CDSymbol *> *_symbols;
+
+    // Class name -> symbol index
+    NSDictionary<NSString *, NSNumber *> *_classSymbols;
+    NSDictionary<NSString *, NSNumber *> *_externalClassSymbols;
     
     struct {
         unsigned int didFindBaseAddress:1;
@@ -50,6 +97,7 @@
         
         _symbols = nil;
         _baseAddress = 0;
+        _materializedSymbols = [[NSMutableDictionary alloc] init];
         
         _classSymbols = nil;
         
@@ -98,93 +146,147 @@
         }
     }
     
-    NSMutableArray *symbols = [[NSMutableArray alloc] init];
-    NSMutableDictionary *classSymbols = [[NSMutableDictionary alloc] init];
-    NSMutableDictionary *externalClassSymbols = [[NSMutableDictionary alloc] init];
-    
-    CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile offset:_symtabCommand.symoff];
-    CDLogVerbose(@"loadSymbols cursor offset= %lu", [cursor offset]);
+    _is64Bit = [self.machOFile uses64BitABI];
+    _isBigEndian = self.machOFile.byteOrder == CDByteOrder_BigEndian;
+    NSUInteger nlistSize = _is64Bit ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    _nlistData   = [self.machOFile dataViewAtOffset:_symtabCommand.symoff length:(NSUInteger)_symtabCommand.nsyms * nlistSize];
+    _stringTable = [self.machOFile dataViewAtOffset:_symtabCommand.stroff length:_symtabCommand.strsize];
+    _symbolCount = [_nlistData length] / nlistSize;
+    CDLogVerbose(@"symoff=  %u", _symtabCommand.symoff);
     CDLogVerbose(@"stroff=  %u", _symtabCommand.stroff);
     CDLogVerbose(@"strsize= %u", _symtabCommand.strsize);
-    
-    const char *strtab = (char *)[self.machOFile.data bytes] + _symtabCommand.stroff;
-    
-    void (^addSymbol)(NSString *, CDSymbol *) = ^(NSString *name, CDSymbol *symbol) {
-        [symbols addObject:symbol];
-        
-        NSString *className = [CDSymbol classNameFromSymbolName:symbol.name];
-        if (className != nil) {
-            CDLogVerbose(@"className: %@ from symbolName: %@", className, symbol.name);
-            if (symbol.value != 0)
-                classSymbols[className] = symbol;
+
+    NSMutableDictionary *classSymbols = [[NSMutableDictionary alloc] init];
+    NSMutableDictionary *externalClassSymbols = [[NSMutableDictionary alloc] init];
+
+    const char *strtab = (const char *)[_stringTable bytes];
+    NSUInteger strsize = [_stringTable length];
+    NSUInteger matchCount = 0;
+    uint8_t *bitmap = CDMarkClassSymbolPrefixes(strtab, strsize, &matchCount);
+    if (bitmap != NULL && matchCount > 0) {
+        // Only n_strx is read for symbols that aren't classes.
+        const uint8_t *nlists = (const uint8_t *)[_nlistData bytes];
+        for (NSUInteger index = 0; index < _symbolCount; index++) {
+            const uint8_t *entry = nlists + index * nlistSize;
+            uint32_t strx = [self _uint32AtBytes:entry];
+            if (strx >= strsize || (bitmap[strx / 8] & (1 << (strx % 8))) == 0)
+                continue;
+
+            const char *name = strtab + strx + CDClassSymbolPrefixLength;
+            NSUInteger nameLength = strnlen(name, strsize - strx - CDClassSymbolPrefixLength);
+            NSString *className = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSASCIIStringEncoding];
+            if (className == nil)
+                continue;
+
+            uint64_t value = _is64Bit ? [self _uint64AtBytes:entry + 8] : [self _uint32AtBytes:entry + 8];
+            if (value != 0)
+                classSymbols[className] = @(index);
             else
-                externalClassSymbols[className] = symbol;
-        }
-    };
-    
-    if (![self.machOFile uses64BitABI]) {
-        //CDLogVerbose(@"32 bit...");
-        //CDLogVerbose(@"       str table index  type  sect  desc  value");
-        //CDLogVerbose(@"       ---------------  ----  ----  ----  --------");
-        for (uint32_t index = 0; index < _symtabCommand.nsyms; index++) {
-            struct nlist nlist;
-            
-            nlist.n_un.n_strx = [cursor readInt32];
-            nlist.n_type      = [cursor readByte];
-            nlist.n_sect      = [cursor readByte];
-            nlist.n_desc      = [cursor readInt16];
-            nlist.n_value     = [cursor readInt32];
-//#if VERBOSE_TABLES
-            CDLogVerbose(@"%5u: %08x           %02x    %02x  %04x  %08x - %s",
-                       index, nlist.n_un.n_strx, nlist.n_type, nlist.n_sect, nlist.n_desc, nlist.n_value, strtab + nlist.n_un.n_strx);
-//#endif
-            
-            const char *ptr = strtab + nlist.n_un.n_strx;
-            NSString *str = [[NSString alloc] initWithBytes:ptr length:strlen(ptr) encoding:NSASCIIStringEncoding];
-            
-            CDSymbol *symbol = [[CDSymbol alloc] initWithName:str machOFile:self.machOFile nlist32:nlist];
-            addSymbol(str, symbol);
-        }
-        
-        //CDLogVerbose(@"Loaded %lu 32-bit symbols", [symbols count]);
-    } else {
-//#ifdef VERBOSE_TABLES
-        CDLogVerbose(@"       str table index  type  sect  desc  value");
-        CDLogVerbose(@"       ---------------  ----  ----  ----  ----------------");
-//#endif
-        for (uint32_t index = 0; index < _symtabCommand.nsyms; index++) {
-            struct nlist_64 nlist;
-            
-            nlist.n_un.n_strx = [cursor readInt32];
-            nlist.n_type      = [cursor readByte];
-            nlist.n_sect      = [cursor readByte];
-            nlist.n_desc      = [cursor readInt16];
-            nlist.n_value     = [cursor readInt64];
-//#ifdef VERBOSE_TABLES
-            CDLogVerbose(@"%5u: %08x           %02x    %02x  %04x  %016llx - %s",
-                       index, nlist.n_un.n_strx, nlist.n_type, nlist.n_sect, nlist.n_desc, nlist.n_value, strtab + nlist.n_un.n_strx);
-//#endif
-            const char *ptr = strtab + nlist.n_un.n_strx;
-            NSString *str = [[NSString alloc] initWithBytes:ptr length:strlen(ptr) encoding:NSASCIIStringEncoding];
-            
-            CDSymbol *symbol = [[CDSymbol alloc] initWithName:str machOFile:self.machOFile nlist64:nlist];
-            addSymbol(str, symbol);
+                externalClassSymbols[className] = @(index);
         }
-        
-        CDLogVerbose(@"Loaded %lu 64-bit symbols", [symbols count]);
     }
-    
-    _symbols = [symbols copy];
+    free(bitmap);
+
     _classSymbols = [classSymbols copy];
     _externalClassSymbols = [externalClassSymbols copy];
-    
-    CDLogVerbose(@"symbols: %@", _symbols);
+
+    CDLogVerbose(@"Indexed %lu class symbols out of %lu %@ symbols", [classSymbols count] + [externalClassSymbols count], _symbolCount, _is64Bit ? @"64-bit" : @"32-bit");
+    if (CDSymbolTableTracingEnabled()) {
+        for (NSUInteger index = 0; index < _symbolCount; index++)
+            CDLogVerbose(@"%5lu: %@", index, [self symbolAtIndex:index]);
+    }
     CDLogVerbose(@"classSymbols: %@", _classSymbols);
     CDLogVerbose(@"externalClassSymbols: %@", _externalClassSymbols);
     CDLogVerbose_HEX(@"baseAddress", [self baseAddress]);
-    //CDLogVerbose(@"baseAddress: %016llx : %lu",[self baseAddress], [self baseAddress]);
 }
 
+- (uint32_t)_uint32AtBytes:(const uint8_t *)bytes;
+{
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return _isBigEndian ? OSSwapBigToHostInt32(value) : OSSwapLittleToHostInt32(value);
+}
+
+- (uint64_t)_uint64AtBytes:(const uint8_t *)bytes;
+{
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return _isBigEndian ? OSSwapBigToHostInt64(value) : OSSwapLittleToHostInt64(value);
+}
+
+#pragma mark - Symbols
+
+- (NSUInteger)symbolCount;
+{
+    return _symbolCount;
+}
+
+- (CDSymbol *)symbolAtIndex:(NSUInteger)index;
+{
+    if (index >= _symbolCount)
+        return nil;
+
+    @synchronized (self) {
+        CDSymbol *symbol = _materializedSymbols[@(index)];
+        if (symbol != nil)
+            return symbol;
+    }
+
+    const uint8_t *entry = (const uint8_t *)[_nlistData bytes] + index * (_is64Bit ? sizeof(struct nlist_64) : sizeof(struct nlist));
+    const char *strtab = (const char *)[_stringTable bytes];
+    NSUInteger strsize = [_stringTable length];
+
+    uint32_t strx = [self _uint32AtBytes:entry];
+    NSString *name = @"";
+    if (strx < strsize)
+        name = [[NSString alloc] initWithBytes:strtab + strx length:strnlen(strtab + strx, strsize - strx) encoding:NSASCIIStringEncoding];
+
+    CDSymbol *symbol;
+    if (_is64Bit) {
+        struct nlist_64 nlist;
+        nlist.n_un.n_strx = strx;
+        nlist.n_type      = entry[4];
+        nlist.n_sect      = entry[5];
+        nlist.n_desc      = (uint16_t)(_isBigEndian ? (entry[6] << 8 | entry[7]) : (entry[7] << 8 | entry[6]));
+        nlist.n_value     = [self _uint64AtBytes:entry + 8];
+        symbol = [[CDSymbol alloc] initWithName:name machOFile:self.machOFile nlist64:nlist];
+    } else {
+        struct nlist nlist;
+        nlist.n_un.n_strx = strx;
+        nlist.n_type      = entry[4];
+        nlist.n_sect      = entry[5];
+        nlist.n_desc      = (int16_t)(_isBigEndian ? (entry[6] << 8 | entry[7]) : (entry[7] << 8 | entry[6]));
+        nlist.n_value     = [self _uint32AtBytes:entry + 8];
+        symbol = [[CDSymbol alloc] initWithName:name machOFile:self.machOFile nlist32:nlist];
+    }
+
+    @synchronized (self) {
+        CDSymbol *existing = _materializedSymbols[@(index)];
+        if (existing != nil)
+            return existing;
+        _materializedSymbols[@(index)] = symbol;
+    }
+
+    return symbol;
+}
+
+- (NSArray<CDSymbol *> *)symbols;
+{
+    @synchronized (self) {
+        if (_symbols != nil)
+            return _symbols;
+    }
+
+    NSMutableArray *symbols = [[NSMutableArray alloc] initWithCapacity:_symbolCount];
+    for (NSUInteger index = 0; index < _symbolCount; index++)
+        [symbols addObject:[self symbolAtIndex:index]];
+
+    @synchronized (self) {
+        if (_symbols == nil)
+            _symbols = [symbols copy];
+        return _symbols;
+    }
+}
 
 - (uint32_t)symoff;
 {
@@ -218,12 +320,14 @@
 
 - (CDSymbol *)symbolForClassName:(NSString *)className;
 {
-    return _classSymbols[className];
+    NSNumber *index = _classSymbols[className];
+    return index != nil ? [self symbolAtIndex:[index unsignedIntegerValue]] : nil;
 }
 
 - (CDSymbol *)symbolForExternalClassName:(NSString *)className
 {
-    return _externalClassSymbols[className];
+    NSNumber *index = _externalClassSymbols[className];
+    return index != nil ? [self symbolAtIndex:[index unsignedIntegerValue]] : nil;
 }
 
 @end
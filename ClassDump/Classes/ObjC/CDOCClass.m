@@ -54,6 +54,14 @@
     return [_superClassRef className];
 }
 
+- (void)parseTypes;
+{
+    [super parseTypes];
+
+    for (CDOCInstanceVariable *instanceVariable in self.instanceVariables)
+        [instanceVariable type];
+}
+
 - (void)registerTypesWithObject:(CDTypeController *)typeController phase:(NSUInteger)phase;
 {
     [super registerTypesWithObject:typeController phase:phase];
@@ -23,5 +23,7 @@
 - (instancetype)initWithClassObject:(CDOCClass *)classObject;
 - (instancetype)initWithClassSymbol:(CDSymbol *)symbol;
 - (instancetype)initWithClassName:(NSString *)className;
+// For a class known only by name, which is defined in this image when isExternal is NO.
+- (instancetype)initWithClassName:(NSString *)className external:(BOOL)isExternal;
 
 @end
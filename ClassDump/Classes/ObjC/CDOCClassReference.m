@@ -8,6 +8,9 @@
 #import <ClassDump/CDSymbol.h>
 #import <ClassDump/ClassDumpUtils.h>
 @implementation CDOCClassReference
+{
+    BOOL _isKnownInternalClass;
+}
 
 - (instancetype)initWithClassSymbol:(CDSymbol *)symbol;
 {
@@ -36,6 +39,15 @@
     return self;
 }
 
+- (instancetype)initWithClassName:(NSString *)className external:(BOOL)isExternal;
+{
+    if ((self = [self initWithClassName:className])) {
+        _isKnownInternalClass = !isExternal;
+    }
+
+    return self;
+}
+
 - (NSString *)className;
 {
     if (_className != nil)
@@ -50,6 +62,9 @@
 
 - (BOOL)isExternalClass;
 {
+    if (_isKnownInternalClass)
+        return NO;
+
     return (!_classObject && (!_classSymbol || [_classSymbol isExternal]));
 }
 
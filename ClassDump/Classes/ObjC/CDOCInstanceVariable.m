@@ -6,7 +6,7 @@
 #import <ClassDump/CDOCInstanceVariable.h>
 #import <ClassDump/CDClassDump.h>
 #import <ClassDump/CDTypeFormatter.h>
-#import <ClassDump/CDTypeParser.h>
+#import <ClassDump/CDTypeParseCache.h>
 #import <ClassDump/CDTypeController.h>
 #import <ClassDump/CDType.h>
 #import <ClassDump/ClassDumpUtils.h>
@@ -57,9 +57,8 @@
 - (CDType *)type;
 {
     if (self.hasParsedType == NO && self.parseError == nil) {
-        CDTypeParser *parser = [[CDTypeParser alloc] initWithString:self.typeString];
         NSError *error;
-        _type = [parser parseType:&error];
+        _type = [[CDTypeParseCache sharedCache] typeForEncoding:self.typeString error:&error];
         if (_type == nil) {
             CDLog(@"Warning: Parsing instance variable type failed, %@", self.name);
             _parseError = error;
@@ -81,7 +80,8 @@
             [resultString appendFormat:@"    // Error: Empty type, name: %@", self.name];
         }
     } else {
-        NSString *formattedString = [[typeController ivarTypeFormatter] formatVariable:self.name type:type];
+        // Formatting changes the type, and the parsed type is shared through CDTypeParseCache.
+        NSString *formattedString = [[typeController ivarTypeFormatter] formatVariable:self.name type:[type copy]];
         NSParameterAssert(formattedString != nil);
         [resultString appendString:formattedString];
         [resultString appendString:@";"];
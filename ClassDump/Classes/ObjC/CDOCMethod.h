@@ -16,6 +16,7 @@
 @property (readonly) NSString *name;
 @property (readonly) NSString *typeString;
 @property (assign) NSUInteger address;
+@property (assign) NSUInteger size; // From LC_FUNCTION_STARTS, 0 if unknown
 
 - (NSArray *)parsedMethodTypes;
 
@@ -7,7 +7,7 @@
 
 #import <ClassDump/CDClassDump.h>
 #import <ClassDump/CDTypeFormatter.h>
-#import <ClassDump/CDTypeParser.h>
+#import <ClassDump/CDTypeParseCache.h>
 #import <ClassDump/CDTypeController.h>
 #import <ClassDump/ClassDumpUtils.h>
 #import <ClassDump/CDClassDumpConfiguration.h>
@@ -17,6 +17,7 @@
     NSString *_name;
     NSString *_typeString;
     NSUInteger _address;
+    NSUInteger _size;
     
     BOOL _hasParsedType;
     NSArray *_parsedMethodTypes;
@@ -51,7 +52,9 @@
 
 - (id)copyWithZone:(NSZone *)zone;
 {
-    return [[CDOCMethod alloc] initWithName:self.name typeString:self.typeString address:self.address];
+    CDOCMethod *method = [[CDOCMethod alloc] initWithName:self.name typeString:self.typeString address:self.address];
+    method.size = self.size;
+    return method;
 }
 
 #pragma mark - Debugging
@@ -69,8 +72,7 @@
     if (_hasParsedType == NO) {
         NSError *error = nil;
 
-        CDTypeParser *parser = [[CDTypeParser alloc] initWithString:self.typeString];
-        _parsedMethodTypes = [parser parseMethodType:&error];
+        _parsedMethodTypes = [[CDTypeParseCache sharedCache] methodTypesForEncoding:self.typeString error:&error];
         if (_parsedMethodTypes == nil)
             CDLog(@"Warning: Parsing method types failed, %@", self.name);
         _hasParsedType = YES;
@@ -81,7 +83,7 @@
 
 - (void)appendToString:(NSMutableString *)resultString typeController:(CDTypeController *)typeController;
 {
-    NSString *formattedString = [typeController.methodTypeFormatter formatMethodName:self.name typeString:self.typeString];
+    NSString *formattedString = [typeController.methodTypeFormatter formatMethodName:self.name typeString:self.typeString methodTypes:self.parsedMethodTypes];
     if (formattedString != nil) {
         [resultString appendString:formattedString];
         [resultString appendString:@";"];
@@ -125,7 +125,7 @@
         CDTypeParser *parser = [[CDTypeParser alloc] initWithString:[[scanner string] substringFromIndex:[scanner scanLocation]]];
         _type = [parser parseType:&error];
         if (_type != nil) {
-            typeRange.length = [parser.lexer.scanner scanLocation];
+            typeRange.length = parser.lexer.scanLocation;
 
             NSString *str = [self.attributeString substringFromIndex:NSMaxRange(typeRange)];
 
@@ -45,6 +45,8 @@
 
 @property (readonly) BOOL hasMethods;
 
+// Parses every method type up front, so registering them later doesn't have to.
+- (void)parseTypes;
 - (void)registerTypesWithObject:(CDTypeController *)typeController phase:(NSUInteger)phase;
 //- (void)registerTypesFromMethods:(NSOrderedSet<CDOCMethod *> *)methods withObject:(CDTypeController *)typeController phase:(NSUInteger)phase;
 
@@ -158,6 +158,13 @@
     return [self.classMethods count] > 0 || [self.instanceMethods count] > 0 || [self.optionalClassMethods count] > 0 || [self.optionalInstanceMethods count] > 0;
 }
 
+- (void)parseTypes; {
+    for (NSOrderedSet<CDOCMethod *> *methods in @[ self.classMethods, self.instanceMethods, self.optionalClassMethods, self.optionalInstanceMethods ]) {
+        for (CDOCMethod *method in methods)
+            [method parsedMethodTypes];
+    }
+}
+
 - (void)registerTypesWithObject:(CDTypeController *)typeController phase:(NSUInteger)phase; {
     [self registerTypesFromMethods:self.classMethods withObject:typeController phase:phase];
     [self registerTypesFromMethods:self.instanceMethods withObject:typeController phase:phase];
@@ -0,0 +1,123 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+
+@class CDMachOFile;
+
+struct cd_objc2_list_header {
+    uint32_t entsize;
+    uint32_t count;
+};
+
+struct cd_objc2_image_info {
+    uint32_t version;
+    uint32_t flags;
+};
+
+
+//
+// 64-bit, also holding 32-bit
+//
+
+struct cd_objc2_class {
+    uint64_t isa;
+    uint64_t superclass;
+    uint64_t cache;
+    uint64_t vtable;
+    uint64_t data; // points to class_ro_t
+    uint64_t reserved1;
+    uint64_t reserved2;
+    uint64_t reserved3;
+};
+
+struct cd_objc2_class_ro_t {
+    uint32_t flags;
+    uint32_t instanceStart;
+    uint32_t instanceSize;
+    uint32_t reserved; // *** this field does not exist in the 32-bit version ***
+    uint64_t ivarLayout;
+    uint64_t name;
+    uint64_t baseMethods;
+    uint64_t baseProtocols;
+    uint64_t ivars;
+    uint64_t weakIvarLayout;
+    uint64_t baseProperties;
+};
+
+struct cd_objc2_method {
+    uint64_t name;
+    uint64_t types;
+    uint64_t imp;
+};
+
+struct cd_objc2_ivar {
+    uint64_t offset;
+    uint64_t name;
+    uint64_t type;
+    uint32_t alignment;
+    uint32_t size;
+};
+
+struct cd_objc2_property {
+    uint64_t name;
+    uint64_t attributes;
+};
+
+struct cd_objc2_protocol {
+    uint64_t isa;
+    uint64_t name;
+    uint64_t protocols;
+    uint64_t instanceMethods;
+    uint64_t classMethods;
+    uint64_t optionalInstanceMethods;
+    uint64_t optionalClassMethods;
+    uint64_t instanceProperties; // So far, always 0
+    uint32_t size; // sizeof(cd_objc2_protocol)
+    uint32_t flags;
+    uint64_t extendedMethodTypes;
+};
+
+struct cd_objc2_category {
+    uint64_t name;
+    uint64_t cls; // Not "class", this header is also compiled as C++
+    uint64_t instanceMethods;
+    uint64_t classMethods;
+    uint64_t protocols;
+    uint64_t instanceProperties;
+    uint64_t v7;
+    uint64_t v8;
+};
+
+// Readers for the ObjC2 runtime structures, specialized at compile time for each pointer size and byte order.  The
+// table is picked once per image, so decoding a structure is one indirect call with no per-field branches.  All of
+// these read from bytes whose bounds have already been checked, at the sizes given in the table.
+typedef struct {
+    NSUInteger ptrSize;
+    NSUInteger classSize;     // objc_class
+    NSUInteger classDataSize; // class_ro_t
+    NSUInteger categorySize;
+    NSUInteger protocolSize;  // Up to and including flags, extendedMethodTypes is optional
+    NSUInteger methodSize;    // Pointer based method_t, small methods are always three int32_t
+    NSUInteger ivarSize;
+    NSUInteger propertySize;
+
+    uint32_t (*readInt32)(const uint8_t *bytes);
+    uint64_t (*readPtr)(const uint8_t *bytes);
+
+    void (*readClass)(const uint8_t *bytes, struct cd_objc2_class *objc2Class);
+    void (*readClassData)(const uint8_t *bytes, struct cd_objc2_class_ro_t *objc2ClassData);
+    void (*readCategory)(const uint8_t *bytes, struct cd_objc2_category *objc2Category);
+    void (*readProtocol)(const uint8_t *bytes, struct cd_objc2_protocol *objc2Protocol);
+
+    // Whole lists at once, the count has already been validated.  Small methods come back as resolved name/types/imp
+    // addresses, three per method, given the address of the first entry.  The name is still the selector reference.
+    void (*readMethods)(const uint8_t *bytes, uint32_t count, struct cd_objc2_method *methods);
+    void (*readSmallMethods)(const uint8_t *bytes, uint32_t count, uint64_t address, uint64_t *addresses);
+    void (*readIvars)(const uint8_t *bytes, uint32_t count, struct cd_objc2_ivar *ivars);
+    void (*readProperties)(const uint8_t *bytes, uint32_t count, struct cd_objc2_property *properties);
+} CDObjectiveC2Decoders;
+
+FOUNDATION_EXTERN const CDObjectiveC2Decoders *CDObjectiveC2DecodersForMachOFile(CDMachOFile *machOFile);
@@ -0,0 +1,177 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDObjectiveC2Decoders.h>
+
+#include <libkern/OSByteOrder.h>
+#import <ClassDump/CDMachOFile.h>
+
+namespace {
+
+template <bool BigEndian> struct CDByteOrderReader;
+
+template <> struct CDByteOrderReader<false> {
+    static inline uint32_t read32(const uint8_t *bytes) { return OSReadLittleInt32(bytes, 0); }
+    static inline uint64_t read64(const uint8_t *bytes) { return OSReadLittleInt64(bytes, 0); }
+};
+
+template <> struct CDByteOrderReader<true> {
+    static inline uint32_t read32(const uint8_t *bytes) { return OSReadBigInt32(bytes, 0); }
+    static inline uint64_t read64(const uint8_t *bytes) { return OSReadBigInt64(bytes, 0); }
+};
+
+template <typename Pointer, bool BigEndian> struct CDPointerReader;
+
+template <bool BigEndian> struct CDPointerReader<uint32_t, BigEndian> {
+    static inline uint64_t read(const uint8_t *bytes) { return CDByteOrderReader<BigEndian>::read32(bytes); }
+};
+
+template <bool BigEndian> struct CDPointerReader<uint64_t, BigEndian> {
+    static inline uint64_t read(const uint8_t *bytes) { return CDByteOrderReader<BigEndian>::read64(bytes); }
+};
+
+template <typename Pointer, bool BigEndian> struct CDObjectiveC2Reader {
+    typedef CDByteOrderReader<BigEndian> Order;
+    static const size_t P = sizeof(Pointer);
+    // class_ro_t only has the reserved field in the 64-bit ABI.
+    static const size_t ClassDataHeaderSize = (P == 8) ? 4 * sizeof(uint32_t) : 3 * sizeof(uint32_t);
+
+    static inline uint64_t ptr(const uint8_t *bytes, size_t index) { return CDPointerReader<Pointer, BigEndian>::read(bytes + index * P); }
+
+    static uint32_t readInt32(const uint8_t *bytes) { return Order::read32(bytes); }
+    static uint64_t readPtr(const uint8_t *bytes)   { return ptr(bytes, 0); }
+
+    static void readClass(const uint8_t *bytes, struct cd_objc2_class *objc2Class)
+    {
+        objc2Class->isa        = ptr(bytes, 0);
+        objc2Class->superclass = ptr(bytes, 1);
+        objc2Class->cache      = ptr(bytes, 2);
+        objc2Class->vtable     = ptr(bytes, 3);
+        objc2Class->data       = ptr(bytes, 4);
+        objc2Class->reserved1  = ptr(bytes, 5);
+        objc2Class->reserved2  = ptr(bytes, 6);
+        objc2Class->reserved3  = ptr(bytes, 7);
+    }
+
+    static void readClassData(const uint8_t *bytes, struct cd_objc2_class_ro_t *objc2ClassData)
+    {
+        objc2ClassData->flags         = Order::read32(bytes);
+        objc2ClassData->instanceStart = Order::read32(bytes + 4);
+        objc2ClassData->instanceSize  = Order::read32(bytes + 8);
+        objc2ClassData->reserved      = (P == 8) ? Order::read32(bytes + 12) : 0;
+
+        const uint8_t *pointers = bytes + ClassDataHeaderSize;
+        objc2ClassData->ivarLayout     = ptr(pointers, 0);
+        objc2ClassData->name           = ptr(pointers, 1);
+        objc2ClassData->baseMethods    = ptr(pointers, 2);
+        objc2ClassData->baseProtocols  = ptr(pointers, 3);
+        objc2ClassData->ivars          = ptr(pointers, 4);
+        objc2ClassData->weakIvarLayout = ptr(pointers, 5);
+        objc2ClassData->baseProperties = ptr(pointers, 6);
+    }
+
+    static void readCategory(const uint8_t *bytes, struct cd_objc2_category *objc2Category)
+    {
+        objc2Category->name               = ptr(bytes, 0);
+        objc2Category->cls                = ptr(bytes, 1);
+        objc2Category->instanceMethods    = ptr(bytes, 2);
+        objc2Category->classMethods       = ptr(bytes, 3);
+        objc2Category->protocols          = ptr(bytes, 4);
+        objc2Category->instanceProperties = ptr(bytes, 5);
+        objc2Category->v7                 = ptr(bytes, 6);
+        objc2Category->v8                 = ptr(bytes, 7);
+    }
+
+    static void readProtocol(const uint8_t *bytes, struct cd_objc2_protocol *objc2Protocol)
+    {
+        objc2Protocol->isa                     = ptr(bytes, 0);
+        objc2Protocol->name                    = ptr(bytes, 1);
+        objc2Protocol->protocols               = ptr(bytes, 2);
+        objc2Protocol->instanceMethods         = ptr(bytes, 3);
+        objc2Protocol->classMethods            = ptr(bytes, 4);
+        objc2Protocol->optionalInstanceMethods = ptr(bytes, 5);
+        objc2Protocol->optionalClassMethods    = ptr(bytes, 6);
+        objc2Protocol->instanceProperties      = ptr(bytes, 7);
+        objc2Protocol->size                    = Order::read32(bytes + 8 * P);
+        objc2Protocol->flags                   = Order::read32(bytes + 8 * P + 4);
+        objc2Protocol->extendedMethodTypes     = 0;
+    }
+
+    static void readMethods(const uint8_t *bytes, uint32_t count, struct cd_objc2_method *methods)
+    {
+        for (uint32_t index = 0; index < count; index++, bytes += 3 * P) {
+            methods[index].name  = ptr(bytes, 0);
+            methods[index].types = ptr(bytes, 1);
+            methods[index].imp   = ptr(bytes, 2);
+        }
+    }
+
+    // Each of the name/types/imp fields is relative to its own address, so the whole list is one flat array of
+    // int32_t deltas against a linearly increasing base.  No branches or cross-lane dependencies, which lets the
+    // compiler turn this into byte swaps and adds across vector registers.
+    static void readSmallMethods(const uint8_t *bytes, uint32_t count, uint64_t address, uint64_t *addresses)
+    {
+#pragma clang loop vectorize(enable) interleave(enable)
+        for (uint32_t index = 0; index < 3 * count; index++)
+            addresses[index] = address + index * sizeof(int32_t) + (int64_t)(int32_t)Order::read32(bytes + index * sizeof(int32_t));
+    }
+
+    static void readIvars(const uint8_t *bytes, uint32_t count, struct cd_objc2_ivar *ivars)
+    {
+        for (uint32_t index = 0; index < count; index++, bytes += 3 * P + 2 * sizeof(uint32_t)) {
+            ivars[index].offset    = ptr(bytes, 0);
+            ivars[index].name      = ptr(bytes, 1);
+            ivars[index].type      = ptr(bytes, 2);
+            ivars[index].alignment = Order::read32(bytes + 3 * P);
+            ivars[index].size      = Order::read32(bytes + 3 * P + 4);
+        }
+    }
+
+    static void readProperties(const uint8_t *bytes, uint32_t count, struct cd_objc2_property *properties)
+    {
+        for (uint32_t index = 0; index < count; index++, bytes += 2 * P) {
+            properties[index].name       = ptr(bytes, 0);
+            properties[index].attributes = ptr(bytes, 1);
+        }
+    }
+
+    static const CDObjectiveC2Decoders decoders;
+};
+
+template <typename Pointer, bool BigEndian>
+const CDObjectiveC2Decoders CDObjectiveC2Reader<Pointer, BigEndian>::decoders = {
+    P,
+    8 * P,
+    ClassDataHeaderSize + 7 * P,
+    8 * P,
+    8 * P + 2 * sizeof(uint32_t),
+    3 * P,
+    3 * P + 2 * sizeof(uint32_t),
+    2 * P,
+
+    readInt32,
+    readPtr,
+
+    readClass,
+    readClassData,
+    readCategory,
+    readProtocol,
+
+    readMethods,
+    readSmallMethods,
+    readIvars,
+    readProperties,
+};
+
+} // namespace
+
+const CDObjectiveC2Decoders *CDObjectiveC2DecodersForMachOFile(CDMachOFile *machOFile)
+{
+    BOOL isBigEndian = machOFile.byteOrder == CDByteOrder_BigEndian;
+    if (machOFile.uses64BitABI)
+        return isBigEndian ? &CDObjectiveC2Reader<uint64_t, true>::decoders : &CDObjectiveC2Reader<uint64_t, false>::decoders;
+
+    return isBigEndian ? &CDObjectiveC2Reader<uint32_t, true>::decoders : &CDObjectiveC2Reader<uint32_t, false>::decoders;
+}
@@ -6,8 +6,10 @@
 #import <ClassDump/CDObjectiveC2Processor.h>
 #import <ClassDump/CDMachOFile.h>
 #import <ClassDump/CDSection.h>
+#import <ClassDump/CDAddressIndex.h>
 #import <ClassDump/CDLCSegment.h>
-#import <ClassDump/CDMachOFileDataCursor.h>
+#import <ClassDump/CDSpanCursor.h>
+#import <ClassDump/CDObjectiveC2Decoders.h>
 #import <ClassDump/CDOCClass.h>
 #import <ClassDump/CDOCMethod.h>
 #import <ClassDump/CDOCInstanceVariable.h>
@@ -19,105 +21,154 @@
 #import <ClassDump/CDProtocolUniquer.h>
 #import <ClassDump/CDOCClassReference.h>
 #import <ClassDump/CDLCChainedFixups.h>
+#import <ClassDump/CDLCFunctionStarts.h>
 #import <ClassDump/ClassDumpUtils.h>
 #import <ClassDump/CDExtensions.h>
 
-struct cd_objc2_list_header {
-    uint32_t entsize;
-    uint32_t count;
-};
+// The cursor must already have been validated for at least one pointer.
+static inline uint64_t CDReadPointer(const CDObjectiveC2Decoders *decoders, CDSpanCursor *cursor)
+{
+    uint64_t value = decoders->readPtr(cursor->bytes + cursor->offset);
+    CDSpanCursorSkip(cursor, decoders->ptrSize);
+    return value;
+}
 
-struct cd_objc2_image_info {
-    uint32_t version;
-    uint32_t flags;
-};
+// Small methods are resolved straight into method_t's, treated as a flat array of addresses.
+_Static_assert(sizeof(struct cd_objc2_method) == 3 * sizeof(uint64_t), "cd_objc2_method must be three packed addresses");
 
+// Below this many entries a list section isn't worth spreading over the cores.
+static const NSUInteger CDParallelLoadingThreshold = 64;
 
-//
-// 64-bit, also holding 32-bit
-//
+@implementation CDObjectiveC2Processor {
+    const CDObjectiveC2Decoders *_decoders;
+    NSMutableDictionary<NSNumber *, CDOCClass *> *_classesLoadedByAddress; // Including superclasses that aren't in the class list
+}
 
-struct cd_objc2_class {
-    uint64_t isa;
-    uint64_t superclass;
-    uint64_t cache;
-    uint64_t vtable;
-    uint64_t data; // points to class_ro_t
-    uint64_t reserved1;
-    uint64_t reserved2;
-    uint64_t reserved3;
-};
+#pragma mark - Reading structures
 
-struct cd_objc2_class_ro_t {
-    uint32_t flags;
-    uint32_t instanceStart;
-    uint32_t instanceSize;
-    uint32_t reserved; // *** this field does not exist in the 32-bit version ***
-    uint64_t ivarLayout;
-    uint64_t name;
-    uint64_t baseMethods;
-    uint64_t baseProtocols;
-    uint64_t ivars;
-    uint64_t weakIvarLayout;
-    uint64_t baseProperties;
-};
+- (instancetype)initWithMachOFile:(CDMachOFile *)machOFile; {
+    if ((self = [super initWithMachOFile:machOFile])) {
+        _decoders = CDObjectiveC2DecodersForMachOFile(machOFile);
+        _classesLoadedByAddress = [[NSMutableDictionary alloc] init];
+    }
+    
+    return self;
+}
 
-struct cd_objc2_method {
-    uint64_t name;
-    uint64_t types;
-    uint64_t imp;
-};
+- (CDSpanStatus)readClass:(struct cd_objc2_class *)objc2Class atAddress:(uint64_t)address; {
+    CDSpanCursor cursor;
+    CDSpanCursorInit(&cursor, self.machOFile);
+    CDSpanStatus status = CDSpanCursorSeekAddress(&cursor, self.machOFile, address, _decoders->classSize);
+    if (status != CDSpanStatusOK)
+        return status;
+    
+    _decoders->readClass(cursor.bytes + cursor.offset, objc2Class);
+    CDLogVerbose(@"isa: %016llx superclass: %016llx cache: %016llx vtable: %016llx", objc2Class->isa, objc2Class->superclass, objc2Class->cache, objc2Class->vtable);
+    CDLogVerbose(@"data: %016llx r1: %016llx r2: %016llx r3: %016llx", objc2Class->data, objc2Class->reserved1, objc2Class->reserved2, objc2Class->reserved3);
+    
+    return CDSpanStatusOK;
+}
 
-struct cd_objc2_ivar {
-    uint64_t offset;
-    uint64_t name;
-    uint64_t type;
-    uint32_t alignment;
-    uint32_t size;
-};
+- (CDSpanStatus)readClassData:(struct cd_objc2_class_ro_t *)objc2ClassData atAddress:(uint64_t)address; {
+    CDSpanCursor cursor;
+    CDSpanCursorInit(&cursor, self.machOFile);
+    CDSpanStatus status = CDSpanCursorSeekAddress(&cursor, self.machOFile, address, _decoders->classDataSize);
+    if (status != CDSpanStatusOK)
+        return status;
+    
+    _decoders->readClassData(cursor.bytes + cursor.offset, objc2ClassData);
+    return CDSpanStatusOK;
+}
 
-struct cd_objc2_property {
-    uint64_t name;
-    uint64_t attributes;
-};
+- (CDSpanStatus)readCategory:(struct cd_objc2_category *)objc2Category atAddress:(uint64_t)address; {
+    CDSpanCursor cursor;
+    CDSpanCursorInit(&cursor, self.machOFile);
+    CDSpanStatus status = CDSpanCursorSeekAddress(&cursor, self.machOFile, address, _decoders->categorySize);
+    if (status != CDSpanStatusOK)
+        return status;
+    
+    _decoders->readCategory(cursor.bytes + cursor.offset, objc2Category);
+    return CDSpanStatusOK;
+}
 
-struct cd_objc2_protocol {
-    uint64_t isa;
-    uint64_t name;
-    uint64_t protocols;
-    uint64_t instanceMethods;
-    uint64_t classMethods;
-    uint64_t optionalInstanceMethods;
-    uint64_t optionalClassMethods;
-    uint64_t instanceProperties; // So far, always 0
-    uint32_t size; // sizeof(cd_objc2_protocol)
-    uint32_t flags;
-    uint64_t extendedMethodTypes;
-};
+- (CDSpanStatus)readProtocol:(struct cd_objc2_protocol *)objc2Protocol atAddress:(uint64_t)address; {
+    CDSpanCursor cursor;
+    CDSpanCursorInit(&cursor, self.machOFile);
+    CDSpanStatus status = CDSpanCursorSeekAddress(&cursor, self.machOFile, address, _decoders->protocolSize);
+    if (status != CDSpanStatusOK)
+        return status;
+    
+    _decoders->readProtocol(cursor.bytes + cursor.offset, objc2Protocol);
+    CDSpanCursorSkip(&cursor, _decoders->protocolSize);
+    
+    BOOL hasExtendedMethodTypesField = objc2Protocol->size > _decoders->protocolSize;
+    if (hasExtendedMethodTypesField && CDSpanCursorExtend(&cursor, 1, _decoders->ptrSize) == CDSpanStatusOK)
+        objc2Protocol->extendedMethodTypes = _decoders->readPtr(cursor.bytes + cursor.offset);
+    
+    return CDSpanStatusOK;
+}
 
-struct cd_objc2_category {
-    uint64_t name;
-    uint64_t class;
-    uint64_t instanceMethods;
-    uint64_t classMethods;
-    uint64_t protocols;
-    uint64_t instanceProperties;
-    uint64_t v7;
-    uint64_t v8;
-};
+// Validates the list header and the entries behind it.  On success the cursor is left at the first entry.
+- (CDSpanStatus)seekList:(CDSpanCursor *)cursor atAddress:(uint64_t)address header:(struct cd_objc2_list_header *)listHeader; {
+    CDSpanCursorInit(cursor, self.machOFile);
+    CDSpanStatus status = CDSpanCursorSeekAddress(cursor, self.machOFile, address, sizeof(*listHeader));
+    if (status != CDSpanStatusOK)
+        return status;
+    
+    listHeader->entsize = _decoders->readInt32(cursor->bytes + cursor->offset);
+    listHeader->count   = _decoders->readInt32(cursor->bytes + cursor->offset + sizeof(uint32_t));
+    CDSpanCursorSkip(cursor, sizeof(*listHeader));
+    
+    return CDSpanStatusOK;
+}
 
+#pragma mark -
 
-@implementation CDObjectiveC2Processor {
-    NSUInteger fixupAdjustment; //old relic can probably prune...
+// Loads every entry of a __objc_*list section.  The pointers are read up front, then loaded on all cores when
+// there are enough of them.  load may rewrite the address it's given, add sees the results in section order.
+- (void)loadEntriesOfListSection:(CDSection *)section load:(id (^)(uint64_t *address))load add:(void (^)(id object, uint64_t address))add; {
+    CDSpanCursor cursor;
+    CDSpanCursorInitWithSection(&cursor, self.machOFile, section);
+    NSUInteger count = CDSpanCursorRemaining(&cursor) / _decoders->ptrSize;
+    if (count == 0)
+        return;
+    
+    uint64_t *addresses = malloc(count * sizeof(uint64_t));
+    __strong id *objects = (__strong id *)calloc(count, sizeof(id));
+    if (addresses == NULL || objects == NULL) {
+        free(addresses);
+        free(objects);
+        return;
+    }
+    for (NSUInteger index = 0; index < count; index++)
+        addresses[index] = CDReadPointer(_decoders, &cursor);
+    
+    if (self.loadsInParallel && count >= CDParallelLoadingThreshold) {
+        dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+            objects[index] = load(&addresses[index]);
+        });
+    } else {
+        for (NSUInteger index = 0; index < count; index++)
+            objects[index] = load(&addresses[index]);
+    }
+    
+    for (NSUInteger index = 0; index < count; index++) {
+        if (add != nil && objects[index] != nil)
+            add(objects[index], addresses[index]);
+        objects[index] = nil;
+    }
+    free(objects);
+    free(addresses);
 }
 
 - (void)loadProtocols; {
     
     CDSection *section = [[self.machOFile dataConstSegment] sectionWithName:@"__objc_protolist"];
     CDLogVerbose(@"\nProtocols section: %@", section);
-    CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithSection:section];
-    while ([cursor isAtEnd] == NO)
-        [self protocolAtAddress:[cursor readPtr]];
+    // Protocols are gathered in the uniquer, keyed by address, so there's nothing to collect here.
+    [self loadEntriesOfListSection:section load:^id(uint64_t *address) {
+        return [self protocolAtAddress:*address];
+    } add:nil];
 }
 
 - (void)loadClasses; {
@@ -126,42 +177,39 @@ struct cd_objc2_category {
     CDSection *section = [segment sectionWithName:@"__objc_classlist"];
     CDLogVerbose(@"\nClasses section: %@", section);
     NSUInteger adjustment = segment.vmaddr - segment.fileoff;
-    NSUInteger based = 0;
     CDLogVerbose(@"\nsegment addr: %#010llx section: %@ offset: %#010llx adj: %#010llx", segment.vmaddr, section, section.segment.fileoff, adjustment);
     
-    CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithSection:section];
-    CDLogVerbose(@"cursor: %#010llx", cursor.offset);
-    while ([cursor isAtEnd] == NO) {
-        uint64_t val = [cursor readPtr];
+    [self loadEntriesOfListSection:section load:^id(uint64_t *address) {
+        uint64_t val = *address;
+        uint64_t based = 0;
         if (self.machOFile.chainedFixups != nil){
             based = [self.machOFile.chainedFixups rebaseTargetFromAddress:val];
             CDLogInfo_HEX(@"loadClasses based", based);
         }
         if (based != 0) {
-            fixupAdjustment = val - based;
-            CDLogInfo_HEX(@"loadClasses fixup", fixupAdjustment);
+            CDLogInfo_HEX(@"loadClasses fixup", val - based);
             val = based;
-            
         }
         CDLogInfo_HEX(@"readPtr", val);
+        *address = val;
         CDOCClass *aClass = [self loadClassAtAddress:val];
         CDLogInfo(@"\naClass: %@\n", aClass);
         CDLogInfo(@"\n");
-        if (aClass != nil) {
-            [self addClass:aClass withAddress:val];
-        }
-    }
+        return aClass;
+    } add:^(id aClass, uint64_t address) {
+        [self addClass:aClass withAddress:address];
+    }];
 }
 
 - (void)loadCategories; {
     
     CDSection *section = [[self.machOFile dataConstSegment] sectionWithName:@"__objc_catlist"];
     CDLogVerbose(@"\nCategories section: %@", section);
-    CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithSection:section];
-    while ([cursor isAtEnd] == NO) {
-        CDOCCategory *category = [self loadCategoryAtAddress:[cursor readPtr]];
+    [self loadEntriesOfListSection:section load:^id(uint64_t *address) {
+        return [self loadCategoryAtAddress:*address];
+    } add:^(id category, uint64_t address) {
         [self addCategory:category];
-    }
+    }];
 }
 
 - (CDOCProtocol *)protocolAtAddress:(uint64_t)address; {
@@ -171,34 +219,27 @@ struct cd_objc2_category {
     CDOCProtocol *protocol = [self.protocolUniquer protocolWithAddress:address];
     if (protocol == nil) {
         protocol = [[CDOCProtocol alloc] init];
-        [self.protocolUniquer setProtocol:protocol withAddress:address];
+        // Whoever gathers it first loads it, anyone else gets the same (possibly still loading) instance.
+        CDOCProtocol *existingProtocol = [self.protocolUniquer protocolWithAddress:address orSetProtocol:protocol];
+        if (existingProtocol != nil)
+            return existingProtocol;
         CDLogInfo(@"\n%s, address=%016llx\n", __PRETTY_FUNCTION__, address);
-        CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-        if ([cursor offset] == 0 ) return nil;
-        //NSParameterAssert([cursor offset] != 0);
         
         struct cd_objc2_protocol objc2Protocol;
-        objc2Protocol.isa                     = [cursor readPtr];
-        objc2Protocol.name                    = [cursor readPtr];
-        objc2Protocol.protocols               = [cursor readPtr];
-        objc2Protocol.instanceMethods         = [cursor readPtr];
-        objc2Protocol.classMethods            = [cursor readPtr];
-        objc2Protocol.optionalInstanceMethods = [cursor readPtr];
-        objc2Protocol.optionalClassMethods    = [cursor readPtr];
-        objc2Protocol.instanceProperties      = [cursor readPtr];
-        objc2Protocol.size                    = [cursor readInt32];
-        objc2Protocol.flags                   = [cursor readInt32];
-        objc2Protocol.extendedMethodTypes     = 0;
+        CDSpanStatus status = [self readProtocol:&objc2Protocol atAddress:address];
+        if (status != CDSpanStatusOK) {
+            CDLogInfo(@"Couldn't read protocol at %016llx: %@", address, CDSpanStatusDescription(status));
+            return nil;
+        }
         
-        CDMachOFileDataCursor *extendedMethodTypesCursor = nil;
-        BOOL hasExtendedMethodTypesField = objc2Protocol.size > 8 * [self.machOFile ptrSize] + 2 * sizeof(uint32_t);
-        if (hasExtendedMethodTypesField) {
-            objc2Protocol.extendedMethodTypes = [cursor readPtr];
-            if (objc2Protocol.extendedMethodTypes != 0) {
-                
-                extendedMethodTypesCursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:objc2Protocol.extendedMethodTypes];
-                NSParameterAssert([extendedMethodTypesCursor offset] != 0);
-            }
+        CDSpanCursor extendedMethodTypesCursor;
+        BOOL hasExtendedMethodTypes = NO;
+        if (objc2Protocol.extendedMethodTypes != 0) {
+            CDSpanCursorInit(&extendedMethodTypesCursor, self.machOFile);
+            status = CDSpanCursorSeekAddress(&extendedMethodTypesCursor, self.machOFile, objc2Protocol.extendedMethodTypes, 0);
+            hasExtendedMethodTypes = (status == CDSpanStatusOK);
+            if (hasExtendedMethodTypes == NO)
+                CDLogInfo(@"Couldn't read extended method types at %016llx: %@", objc2Protocol.extendedMethodTypes, CDSpanStatusDescription(status));
         }
         
         CDLogVerbose(@"----------------------------------------");
@@ -212,10 +253,18 @@ struct cd_objc2_category {
         
         if (objc2Protocol.protocols != 0) {
             CDLogInfo_HEX(@"setting protocol address", objc2Protocol.protocols);
-            [cursor setAddress:objc2Protocol.protocols];
-            uint64_t count = [cursor readPtr];
+            CDSpanCursor cursor;
+            CDSpanCursorInit(&cursor, self.machOFile);
+            status = CDSpanCursorSeekAddress(&cursor, self.machOFile, objc2Protocol.protocols, _decoders->ptrSize);
+            uint64_t count = (status == CDSpanStatusOK) ? CDReadPointer(_decoders, &cursor) : 0;
+            if (status == CDSpanStatusOK)
+                status = CDSpanCursorExtend(&cursor, count, _decoders->ptrSize);
+            if (status != CDSpanStatusOK) {
+                CDLog(@"Warning: Couldn't read protocol list at %016llx: %@", objc2Protocol.protocols, CDSpanStatusDescription(status));
+                count = 0;
+            }
             for (uint64_t index = 0; index < count; index++) {
-                uint64_t val = [cursor readPtr];
+                uint64_t val = CDReadPointer(_decoders, &cursor);
                 CDOCProtocol *anotherProtocol = [self protocolAtAddress:val];
                 CDLogInfo(@"anotherProtocol: %@", anotherProtocol);
                 if (anotherProtocol != nil) {
@@ -226,20 +275,22 @@ struct cd_objc2_category {
             }
         }
         
+        CDSpanCursor *extendedMethodTypes = hasExtendedMethodTypes ? &extendedMethodTypesCursor : NULL;
+        
         CDLogInfo_HEX(@"\nLoading protocol instanceMethods", objc2Protocol.instanceMethods);
-        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.instanceMethods extendedMethodTypesCursor:extendedMethodTypesCursor])
+        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.instanceMethods extendedMethodTypesCursor:extendedMethodTypes])
             [protocol addInstanceMethod:method];
         
         CDLogInfo_HEX(@"\nLoading protocol classMethods", objc2Protocol.classMethods);
-        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.classMethods extendedMethodTypesCursor:extendedMethodTypesCursor])
+        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.classMethods extendedMethodTypesCursor:extendedMethodTypes])
             [protocol addClassMethod:method];
         
         CDLogInfo_HEX(@"\nLoading protocol optionalInstanceMethods", objc2Protocol.optionalInstanceMethods);
-        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.optionalInstanceMethods extendedMethodTypesCursor:extendedMethodTypesCursor])
+        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.optionalInstanceMethods extendedMethodTypesCursor:extendedMethodTypes])
             [protocol addOptionalInstanceMethod:method];
         
         CDLogInfo_HEX(@"\nLoading protocol optionalClassMethods", objc2Protocol.optionalClassMethods);
-        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.optionalClassMethods extendedMethodTypesCursor:extendedMethodTypesCursor])
+        for (CDOCMethod *method in [self loadMethodsAtAddress:objc2Protocol.optionalClassMethods extendedMethodTypesCursor:extendedMethodTypes])
             [protocol addOptionalClassMethod:method];
         
         CDLogInfo_HEX(@"\nLoading protocol instanceProperties", objc2Protocol.instanceProperties);
@@ -254,20 +305,15 @@ struct cd_objc2_category {
     if (address == 0)
         return nil;
     
-    CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-    NSParameterAssert([cursor offset] != 0);
     CDLogInfo(@"\n%s, address=%016llx\n", __PRETTY_FUNCTION__, address);
     struct cd_objc2_category objc2Category;
-    objc2Category.name               = [cursor readPtr];
-    objc2Category.class              = [cursor readPtr];
-    objc2Category.instanceMethods    = [cursor readPtr];
-    objc2Category.classMethods       = [cursor readPtr];
-    objc2Category.protocols          = [cursor readPtr];
-    objc2Category.instanceProperties = [cursor readPtr];
-    objc2Category.v7                 = [cursor readPtr];
-    objc2Category.v8                 = [cursor readPtr];
+    CDSpanStatus status = [self readCategory:&objc2Category atAddress:address];
+    if (status != CDSpanStatusOK) {
+        CDLog(@"Warning: Couldn't read category at %016llx: %@", address, CDSpanStatusDescription(status));
+        return nil;
+    }
     CDLogVerbose(@"----------------------------------------");
-    CDLogVerbose(@"name: %016llx class: %016llx instanceMethods: %016llx  classMethods: %016llx", objc2Category.name, objc2Category.class, objc2Category.instanceMethods, objc2Category.classMethods);
+    CDLogVerbose(@"name: %016llx class: %016llx instanceMethods: %016llx  classMethods: %016llx", objc2Category.name, objc2Category.cls, objc2Category.instanceMethods, objc2Category.classMethods);
     CDLogVerbose(@"protocols: %016llx instanceProperties: %016llx v7: %016llx v8: %016llx", objc2Category.protocols, objc2Category.instanceProperties, objc2Category.v7, objc2Category.v8);
     
     CDOCCategory *category = [[CDOCCategory alloc] init];
@@ -297,10 +343,10 @@ struct cd_objc2_category {
         } else if ([self.machOFile hasRelocationEntryForAddress:classNameAddress]) {
             externalClassName = [self.machOFile externalClassNameForAddress:classNameAddress];
             CDLogInfo(@"category: got external class name (1): %@ %@", externalClassName, externalClassName);
-        } else if (objc2Category.class != 0) { //likely workin with a newer chained fixup style macho
-            NSNumber *num = [NSNumber numberWithUnsignedInteger:OSSwapInt64(objc2Category.class)];
-            CDLogInfo(@"category external class !=0: %016llx (%llu) num: %@", objc2Category.class, objc2Category.class, num);
-            externalClassName = [self.machOFile.chainedFixups externalClassNameForAddress:OSSwapInt64(objc2Category.class)];
+        } else if (objc2Category.cls != 0) { //likely workin with a newer chained fixup style macho
+            NSNumber *num = [NSNumber numberWithUnsignedInteger:OSSwapInt64(objc2Category.cls)];
+            CDLogInfo(@"category external class !=0: %016llx (%llu) num: %@", objc2Category.cls, objc2Category.cls, num);
+            externalClassName = [self.machOFile.chainedFixups externalClassNameForAddress:OSSwapInt64(objc2Category.cls)];
         }
         
         if (externalClassName != nil) {
@@ -320,57 +366,32 @@ struct cd_objc2_category {
     if (address == 0)
         return nil;
     
-    CDOCClass *class = [self classWithAddress:address];
+    NSNumber *key = [NSNumber numberWithUnsignedLongLong:address];
+    CDOCClass *class = nil;
+    @synchronized (_classesLoadedByAddress) {
+        class = _classesLoadedByAddress[key];
+    }
     if (class)
         return class;
     
     CDLogInfo(@"\n%s, address=%016llx also: %llu\n", __PRETTY_FUNCTION__, address, address);
-    CDMachOFileDataCursor *cursor = nil;
-    @try {
-        cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-    } @catch (NSException *exception) {
+    struct cd_objc2_class objc2Class;
+    CDSpanStatus status = [self readClass:&objc2Class atAddress:address];
+    if (status != CDSpanStatusOK) {
         CDLogVerbose_HEX(@"address", address);
-        CDLogInfo(@"Caught exception: %@", exception);
+        CDLogInfo(@"Couldn't read class: %@", CDSpanStatusDescription(status));
         return nil;
     }
     
-    if ([cursor offset] == 0) return nil;
-    //NSParameterAssert([cursor offset] != 0);
+    BOOL isSwiftClass     = (objc2Class.data & 0x1) != 0;
+    objc2Class.data       = objc2Class.data & ~7;
     
-    struct cd_objc2_class objc2Class;
-    objc2Class.isa        = [cursor readPtr];
-    objc2Class.superclass = [cursor readPtr];
-    objc2Class.cache      = [cursor readPtr];
-    objc2Class.vtable     = [cursor readPtr];
-    
-    uint64_t value        = [cursor readPtr];
-    
-    class.isSwiftClass    = (value & 0x1) != 0;
-    objc2Class.data       = value & ~7;
-    objc2Class.reserved1  = [cursor readPtr];
-    objc2Class.reserved2  = [cursor readPtr];
-    objc2Class.reserved3  = [cursor readPtr];
-    CDLogVerbose(@"isa: %016llx superclass: %016llx cache: %016llx vtable: %016llx", objc2Class.isa, objc2Class.superclass, objc2Class.cache, objc2Class.vtable);
-    CDLogVerbose(@"data: %016llx r1: %016llx r2: %016llx r3: %016llx", objc2Class.data, objc2Class.reserved1, objc2Class.reserved2, objc2Class.reserved3);
-    
-    NSParameterAssert(objc2Class.data != 0);
-    [cursor setAddress:objc2Class.data];
     struct cd_objc2_class_ro_t objc2ClassData;
-    objc2ClassData.flags         = [cursor readInt32];
-    objc2ClassData.instanceStart = [cursor readInt32];
-    objc2ClassData.instanceSize  = [cursor readInt32];
-    if ([self.machOFile uses64BitABI])
-        objc2ClassData.reserved  = [cursor readInt32];
-    else
-        objc2ClassData.reserved = 0;
-    
-    objc2ClassData.ivarLayout     = [cursor readPtr];
-    objc2ClassData.name           = [cursor readPtr];
-    objc2ClassData.baseMethods    = [cursor readPtr];
-    objc2ClassData.baseProtocols  = [cursor readPtr];
-    objc2ClassData.ivars          = [cursor readPtr];
-    objc2ClassData.weakIvarLayout = [cursor readPtr];
-    objc2ClassData.baseProperties = [cursor readPtr];
+    status = [self readClassData:&objc2ClassData atAddress:objc2Class.data];
+    if (status != CDSpanStatusOK) {
+        CDLog(@"Warning: Couldn't read class data at %016llx for class at %016llx: %@", objc2Class.data, address, CDSpanStatusDescription(status));
+        return nil;
+    }
     
     CDLogInfo(@"flags: %08x instanceStart: %08x instanceSize: %08x reserved: %08x", objc2ClassData.flags, objc2ClassData.instanceStart, objc2ClassData.instanceSize, objc2ClassData.reserved);
     
@@ -381,6 +402,16 @@ struct cd_objc2_category {
     
     CDOCClass *aClass = [[CDOCClass alloc] init];
     [aClass setName:str];
+    aClass.isSwiftClass = isSwiftClass;
+    
+    // Publish the class before chasing its superclass, so a list entry and a subclass reaching it at the same time
+    // share one load.  Until this thread is done the others only hold on to it.
+    @synchronized (_classesLoadedByAddress) {
+        CDOCClass *existingClass = _classesLoadedByAddress[key];
+        if (existingClass != nil)
+            return existingClass;
+        _classesLoadedByAddress[key] = aClass;
+    }
     CDLogInfo(@"\nLoading methods...\n");
     uint64_t methodAddress = objc2ClassData.baseMethods;
     uint64_t ivarsAddress = objc2ClassData.ivars;
@@ -477,25 +508,34 @@ struct cd_objc2_category {
     if (address != 0) {
         struct cd_objc2_list_header listHeader;
         
-        CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-        NSParameterAssert([cursor offset] != 0);
-        CDLogInfo_HEX(@"property list data offset", [cursor offset]);
+        CDSpanCursor cursor;
+        CDSpanStatus status = [self seekList:&cursor atAddress:address header:&listHeader];
+        if (status != CDSpanStatusOK) {
+            CDLog(@"Warning: Couldn't read property list at %016llx: %@", address, CDSpanStatusDescription(status));
+            return properties;
+        }
+        CDLogInfo_HEX(@"property list data offset", cursor.offset - sizeof(listHeader));
         
-        listHeader.entsize = [cursor readInt32];
-        listHeader.count = [cursor readInt32];
-        NSParameterAssert(listHeader.entsize == 2 * [self.machOFile ptrSize]);
+        if (listHeader.entsize != _decoders->propertySize || (status = CDSpanCursorExtend(&cursor, listHeader.count, listHeader.entsize)) != CDSpanStatusOK) {
+            CDLog(@"Warning: Bad property list at %016llx, entsize: %u count: %u", address, listHeader.entsize, listHeader.count);
+            return properties;
+        }
+        
+        struct cd_objc2_property *objc2Properties = malloc(MAX(listHeader.count, 1) * sizeof(struct cd_objc2_property));
+        if (objc2Properties == NULL)
+            return properties;
+        _decoders->readProperties(cursor.bytes + cursor.offset, listHeader.count, objc2Properties);
         
         for (uint32_t index = 0; index < listHeader.count; index++) {
-            struct cd_objc2_property objc2Property;
+            struct cd_objc2_property objc2Property = objc2Properties[index];
             
-            objc2Property.name = [cursor readPtr];
-            objc2Property.attributes = [cursor readPtr];
             NSString *name = [self.machOFile stringAtAddress:objc2Property.name];
             NSString *attributes = [self.machOFile stringAtAddress:objc2Property.attributes];
             
             CDOCProperty *property = [[CDOCProperty alloc] initWithName:name attributes:attributes isClass:isClass];
             [properties addObject:property];
         }
+        free(objc2Properties);
     }
     
     return properties;
@@ -505,108 +545,135 @@ struct cd_objc2_category {
 - (void)loadClassMethodsAndClassPropertiesOfMetaClassAtAddress:(uint64_t)address methods:(NSArray<CDOCMethod *> **)methods properties:(NSArray<CDOCProperty *> **)properties {
     if (address == 0) return;
     CDLogInfo(@"\n%s, address=%016llx\n", __PRETTY_FUNCTION__, address);
-    CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-    NSParameterAssert([cursor offset] != 0);
-    
     struct cd_objc2_class objc2Class;
-    objc2Class.isa        = [cursor readPtr];
-    objc2Class.superclass = [cursor readPtr];
-    objc2Class.cache      = [cursor readPtr];
-    objc2Class.vtable     = [cursor readPtr];
-    objc2Class.data       = [cursor readPtr];
-    objc2Class.reserved1  = [cursor readPtr];
-    objc2Class.reserved2  = [cursor readPtr];
-    objc2Class.reserved3  = [cursor readPtr];
-    CDLogVerbose(@"isa: %016llx superclass: %016llx cache: %016llx vtable: %016llx", objc2Class.isa, objc2Class.superclass, objc2Class.cache, objc2Class.vtable);
-    CDLogVerbose(@"data: %016llx r1: %016llx r2: %016llx r3: %016llx", objc2Class.data, objc2Class.reserved1, objc2Class.reserved2, objc2Class.reserved3);
-    
-    NSParameterAssert(objc2Class.data != 0);
-    [cursor setAddress:objc2Class.data];
+    CDSpanStatus status = [self readClass:&objc2Class atAddress:address];
+    if (status != CDSpanStatusOK) {
+        CDLog(@"Warning: Couldn't read metaclass at %016llx: %@", address, CDSpanStatusDescription(status));
+        return;
+    }
     
     struct cd_objc2_class_ro_t objc2ClassData;
-    objc2ClassData.flags         = [cursor readInt32];
-    objc2ClassData.instanceStart = [cursor readInt32];
-    objc2ClassData.instanceSize  = [cursor readInt32];
-    if ([self.machOFile uses64BitABI])
-        objc2ClassData.reserved  = [cursor readInt32];
-    else
-        objc2ClassData.reserved = 0;
-    
-    objc2ClassData.ivarLayout     = [cursor readPtr];
-    objc2ClassData.name           = [cursor readPtr];
-    objc2ClassData.baseMethods    = [cursor readPtr];
-    objc2ClassData.baseProtocols  = [cursor readPtr];
-    objc2ClassData.ivars          = [cursor readPtr];
-    objc2ClassData.weakIvarLayout = [cursor readPtr];
-    objc2ClassData.baseProperties = [cursor readPtr];
+    status = [self readClassData:&objc2ClassData atAddress:objc2Class.data];
+    if (status != CDSpanStatusOK) {
+        CDLog(@"Warning: Couldn't read metaclass data at %016llx: %@", objc2Class.data, CDSpanStatusDescription(status));
+        return;
+    }
     
     *methods = [self loadMethodsAtAddress:objc2ClassData.baseMethods];
     *properties = [self loadPropertiesAtAddress:objc2ClassData.baseProperties isClass:YES];
 }
 
 - (NSArray<CDOCMethod *> *)loadMethodsAtAddress:(uint64_t)address; {
-    return [self loadMethodsAtAddress:address extendedMethodTypesCursor:nil];
+    return [self loadMethodsAtAddress:address extendedMethodTypesCursor:NULL];
 }
 
-- (NSArray<CDOCMethod *> *)loadMethodsAtAddress:(uint64_t)address extendedMethodTypesCursor:(CDMachOFileDataCursor *)extendedMethodTypesCursor; {
+// Replaces every stride'th entry, a selector reference, with the selector it points to, or 0 if it can't be read.
+// The references of one method list almost always sit together in __objc_selrefs, so the section is looked up once
+// and reused for as long as the references keep landing in it.
+- (void)resolveSelectorReferences:(uint64_t *)references count:(uint32_t)count stride:(uint32_t)stride; {
+    CDMachOFile *machOFile = self.machOFile;
+    CDAddressIndex *addressIndex = machOFile.addressIndex;
+    const uint8_t *bytes = (const uint8_t *)[machOFile.data bytes];
+    NSUInteger length = [machOFile.data length];
+    NSUInteger ptrSize = _decoders->ptrSize;
+    
+    uint64_t sectionStart = 0, sectionEnd = 0, sectionOffset = 0;
+    for (uint32_t index = 0; index < count; index++) {
+        uint64_t *reference = &references[index * stride];
+        uint64_t address = *reference;
+        
+        if (address < sectionStart || address + ptrSize > sectionEnd) {
+            CDSection *section = [addressIndex sectionContainingAddress:address];
+            if (section == nil && machOFile.chainedFixups != nil) {
+                uint64_t basedAddress = [machOFile.chainedFixups rebaseTargetFromAddress:address];
+                if (basedAddress == 0) { //not in fixups, try discarding 'extra' data and using the uint32_t version of the address. some macho / entsize weirdness
+                    CDLogInfo_HEX(@"\nProblem finding address", address);
+                    basedAddress = [machOFile fixupBasedAddress:address];
+                }
+                CDLogInfo_HEX(@"basedName", basedAddress);
+                address = basedAddress;
+                section = [addressIndex sectionContainingAddress:address];
+            }
+            if (section == nil || section.offset == 0 || address + ptrSize > section.addr + section.size) {
+                CDLog(@"Warning: Couldn't read selector reference at %016llx: %@", address, CDSpanStatusDescription(CDSpanStatusOutOfBounds));
+                *reference = 0;
+                continue;
+            }
+            sectionStart  = section.addr;
+            sectionEnd    = section.addr + section.size;
+            sectionOffset = section.offset;
+        }
+        
+        uint64_t offset = sectionOffset + (address - sectionStart);
+        if (offset + ptrSize > length) {
+            CDLog(@"Warning: Couldn't read selector reference at %016llx: %@", address, CDSpanStatusDescription(CDSpanStatusOutOfBounds));
+            *reference = 0;
+            continue;
+        }
+        *reference = _decoders->readPtr(bytes + offset);
+    }
+}
+
+- (NSArray<CDOCMethod *> *)loadMethodsAtAddress:(uint64_t)address extendedMethodTypesCursor:(CDSpanCursor *)extendedMethodTypesCursor; {
     NSMutableArray<CDOCMethod *> *methods = [NSMutableArray array];
     
     if (address != 0) {
-        CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-        CDMachOFileDataCursor *nameCursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile];
-        NSParameterAssert([cursor offset] != 0);
-        CDLogInfo_HEX(@"method list data offset", [cursor offset]);
-        
         struct cd_objc2_list_header listHeader;
         
+        CDSpanCursor cursor;
+        CDSpanStatus status = [self seekList:&cursor atAddress:address header:&listHeader];
+        if (status != CDSpanStatusOK) {
+            CDLog(@"Warning: Couldn't read method list at %016llx: %@", address, CDSpanStatusDescription(status));
+            return methods;
+        }
+        CDLogInfo_HEX(@"method list data offset", cursor.offset - sizeof(listHeader));
+        
         // See https://opensource.apple.com/source/objc4/objc4-787.1/runtime/objc-runtime-new.h
-        uint32_t value = [cursor readInt32];
-        listHeader.entsize = value & ~METHOD_LIST_T_ENTSIZE_MASK;
-        bool small = (value & METHOD_LIST_T_SMALL_METHOD_FLAG) != 0;
-        listHeader.count = [cursor readInt32];
-        NSParameterAssert(listHeader.entsize == 3 * (small ? sizeof(int32_t) : [self.machOFile ptrSize]));
-        if(small) {
-            NSParameterAssert((listHeader.entsize & 0x7FFFFFFF) == 12);
-        } else {
-            NSParameterAssert(listHeader.entsize == 3 * [self.machOFile ptrSize]);
+        bool small = (listHeader.entsize & METHOD_LIST_T_SMALL_METHOD_FLAG) != 0;
+        listHeader.entsize &= ~METHOD_LIST_T_ENTSIZE_MASK;
+        if (listHeader.entsize != (small ? 3 * sizeof(int32_t) : _decoders->methodSize) || (status = CDSpanCursorExtend(&cursor, listHeader.count, listHeader.entsize)) != CDSpanStatusOK) {
+            CDLog(@"Warning: Bad method list at %016llx, entsize: %u count: %u", address, listHeader.entsize, listHeader.count);
+            return methods;
         }
         CDLogInfo(@"\nProcessing %lu methods...\n", listHeader.count);
-        for (uint32_t index = 0; index < listHeader.count; index++) {
-            struct cd_objc2_method objc2Method;
+        
+        // Decode the whole list up front.  Small methods are resolved to name/types/imp in one pass, and their
+        // selector references in a second one, so they end up in the same shape as pointer based methods.
+        struct cd_objc2_method *objc2Methods = malloc(MAX(listHeader.count, 1) * sizeof(struct cd_objc2_method));
+        uint64_t *extendedMethodTypes = calloc(MAX(listHeader.count, 1), sizeof(uint64_t));
+        if (objc2Methods == NULL || extendedMethodTypes == NULL) {
+            free(objc2Methods);
+            free(extendedMethodTypes);
+            return methods;
+        }
+        if (small) {
+            CDLogVerbose(@"\nbiggie smalls is the illest\n");
+            _decoders->readSmallMethods(cursor.bytes + cursor.offset, listHeader.count, address + sizeof(listHeader), (uint64_t *)objc2Methods);
+            [self resolveSelectorReferences:(uint64_t *)objc2Methods count:listHeader.count stride:3];
+        } else {
+            _decoders->readMethods(cursor.bytes + cursor.offset, listHeader.count, objc2Methods);
+        }
+        
+        // The extended types run parallel to every method list of the protocol, in order, so take this list's share
+        // whether or not all of its methods survive.
+        if (extendedMethodTypesCursor != NULL && CDSpanCursorExtend(extendedMethodTypesCursor, listHeader.count, _decoders->ptrSize) == CDSpanStatusOK) {
+            for (uint32_t index = 0; index < listHeader.count; index++)
+                extendedMethodTypes[index] = CDReadPointer(_decoders, extendedMethodTypesCursor);
+        }
+        
+        // Methods are listed in reverse of the order they were declared in, so walk backwards and emit them in their
+        // final order.
+        for (uint32_t index = listHeader.count; index-- > 0; ) {
+            struct cd_objc2_method objc2Method = objc2Methods[index];
+            if (small && objc2Method.name == 0)
+                continue;
             
-            if(small) {
-                CDLogVerbose(@"\nbiggie smalls is the illest\n");
-                uint64_t baseAddress = address + index * 12 + 8;
-                uint64_t name = baseAddress + (int64_t)(int32_t) [cursor readInt32];
-                uint64_t types = baseAddress + 4 + (int64_t)(int32_t) [cursor readInt32];
-                uint64_t imp = baseAddress + 8 + (int64_t)(int32_t) [cursor readInt32];
-                if(self.machOFile.chainedFixups) {
-                    uint64_t basedName = [self.machOFile.chainedFixups rebaseTargetFromAddress:name];
-                    if (basedName != 0) {
-                        CDLogInfo_HEX(@"basedName", basedName);
-                        name = basedName;
-                    } else { //not in fixups, try discarding 'extra' data and using the uint32_t version of the address. some macho / entsize weirdness
-                        CDLogInfo_HEX(@"\nProblem finding address", name);
-                        name = [self.machOFile fixupBasedAddress:name];
-                        CDLogInfo_HEX(@"new value", name);
-                    }
-                }
-                [nameCursor setAddress:name];
-                objc2Method.name = [nameCursor readPtr];
-                objc2Method.types = types;
-                objc2Method.imp = imp;
-            } else {
-                objc2Method.name  = [cursor readPtr];
-                objc2Method.types = [cursor readPtr];
-                objc2Method.imp   = [cursor readPtr];
-            }
             CDLogVerbose_HEX(@"getting string at address for name",objc2Method.name );
             NSString *name    = [self.machOFile stringAtAddress:objc2Method.name];
             NSString *types   = [self.machOFile stringAtAddress:objc2Method.types];
             
-            if (extendedMethodTypesCursor) {
-                uint64_t extendedMethodTypes = [extendedMethodTypesCursor readPtr];
-                types = [self.machOFile stringAtAddress:extendedMethodTypes];
+            if (extendedMethodTypes[index] != 0) {
+                types = [self.machOFile stringAtAddress:extendedMethodTypes[index]];
             }
             
             CDLogInfo(@"%3u: %016llx %016llx %016llx", index, objc2Method.name, objc2Method.types, objc2Method.imp);
@@ -614,55 +681,73 @@ struct cd_objc2_category {
             CDLogInfo(@"types: %@\n", types);
             
             CDOCMethod *method = [[CDOCMethod alloc] initWithName:name typeString:types address:objc2Method.imp];
+            
+            // Small methods hold a relative offset, already resolved.  A pointer may still be a chained rebase.
+            uint64_t imp = objc2Method.imp;
+            if (small == NO && imp != 0 && self.machOFile.chainedFixups != nil) {
+                uint64_t based = [self.machOFile.chainedFixups rebaseTargetFromAddress:imp];
+                if (based != 0)
+                    imp = based;
+            }
+            method.size = [self.machOFile.functionStarts sizeOfFunctionAtAddress:imp];
             [methods addObject:method];
         }
+        free(objc2Methods);
+        free(extendedMethodTypes);
     }
     
-    return [methods reversedArray];
+    return methods;
 }
 
 - (NSArray<CDOCInstanceVariable *> *)loadIvarsAtAddress:(uint64_t)address; {
     NSMutableArray<CDOCInstanceVariable *> *ivars = [NSMutableArray array];
     
     if (address != 0) {
-        CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-        NSParameterAssert([cursor offset] != 0);
-        CDLogInfo_HEX(@"ivar list data offset", [cursor offset]);
-        
         struct cd_objc2_list_header listHeader;
         
-        listHeader.entsize = [cursor readInt32];
-        listHeader.count = [cursor readInt32];
-        NSParameterAssert(listHeader.entsize == 3 * [self.machOFile ptrSize] + 2 * sizeof(uint32_t));
+        CDSpanCursor cursor;
+        CDSpanStatus status = [self seekList:&cursor atAddress:address header:&listHeader];
+        if (status != CDSpanStatusOK) {
+            CDLog(@"Warning: Couldn't read ivar list at %016llx: %@", address, CDSpanStatusDescription(status));
+            return ivars;
+        }
+        CDLogInfo_HEX(@"ivar list data offset", cursor.offset - sizeof(listHeader));
+        
+        if (listHeader.entsize != _decoders->ivarSize || (status = CDSpanCursorExtend(&cursor, listHeader.count, listHeader.entsize)) != CDSpanStatusOK) {
+            CDLog(@"Warning: Bad ivar list at %016llx, entsize: %u count: %u", address, listHeader.entsize, listHeader.count);
+            return ivars;
+        }
         
+        struct cd_objc2_ivar *objc2Ivars = malloc(MAX(listHeader.count, 1) * sizeof(struct cd_objc2_ivar));
+        if (objc2Ivars == NULL)
+            return ivars;
+        _decoders->readIvars(cursor.bytes + cursor.offset, listHeader.count, objc2Ivars);
+        
+        CDSpanCursor offsetCursor;
+        CDSpanCursorInit(&offsetCursor, self.machOFile);
         for (uint32_t index = 0; index < listHeader.count; index++) {
-            struct cd_objc2_ivar objc2Ivar;
-            
-            objc2Ivar.offset    = [cursor readPtr];
-            objc2Ivar.name      = [cursor readPtr];
-            objc2Ivar.type      = [cursor readPtr];
-            objc2Ivar.alignment = [cursor readInt32];
-            objc2Ivar.size      = [cursor readInt32];
+            struct cd_objc2_ivar objc2Ivar = objc2Ivars[index];
             
             if (objc2Ivar.name != 0) {
                 NSString *name       = [self.machOFile stringAtAddress:objc2Ivar.name];
                 NSString *typeString = [self.machOFile stringAtAddress:objc2Ivar.type];
-                @try {
-                    CDMachOFileDataCursor *offsetCursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:objc2Ivar.offset];
-                    NSUInteger offset = (uint32_t)[offsetCursor readPtr]; // objc-runtime-new.h: "offset is 64-bit by accident" => restrict to 32-bit
-                    
-                    CDOCInstanceVariable *ivar = [[CDOCInstanceVariable alloc] initWithName:name typeString:typeString offset:offset];
-                    [ivars addObject:ivar];
-                }
-               
-                @catch (NSException *exception) {
+                NSUInteger offset = 0;
+                status = CDSpanCursorSeekAddress(&offsetCursor, self.machOFile, objc2Ivar.offset, _decoders->ptrSize);
+                if (status == CDSpanStatusOK) {
+                    offset = (uint32_t)CDReadPointer(_decoders, &offsetCursor); // objc-runtime-new.h: "offset is 64-bit by accident" => restrict to 32-bit
+                } else if (status != CDSpanStatusNullAddress) {
                     CDLogVerbose_HEX(@"objc2Ivar.offset", objc2Ivar.offset);
-                    CDLogInfo(@"Caught exception: %@", exception);
+                    CDLogInfo(@"Couldn't read ivar offset: %@", CDSpanStatusDescription(status));
+                    continue;
                 }
+                
+                CDOCInstanceVariable *ivar = [[CDOCInstanceVariable alloc] initWithName:name typeString:typeString offset:offset];
+                [ivars addObject:ivar];
             } else {
                 //CDLogVerbose(@"%016lx %016lx %016lx  %08x %08x", objc2Ivar.offset, objc2Ivar.name, objc2Ivar.type, objc2Ivar.alignment, objc2Ivar.size);
             }
         }
+        free(objc2Ivars);
     }
     
     return ivars;
@@ -674,27 +759,28 @@ struct cd_objc2_category {
     
     if (address != 0) {
         CDLogInfo(@"\n%s, address=%016llx\n", __PRETTY_FUNCTION__, address);
-        CDMachOFileDataCursor *cursor = [[CDMachOFileDataCursor alloc] initWithFile:self.machOFile address:address];
-        if (!cursor){
-            CDLogInfo(@"no cursor for you!!");
-        } else {
-            CDLogInfo(@"cursor: %@", cursor);
-        }
-        uint64_t count = [cursor readPtr];
+        CDSpanCursor cursor;
+        CDSpanCursorInit(&cursor, self.machOFile);
+        CDSpanStatus status = CDSpanCursorSeekAddress(&cursor, self.machOFile, address, _decoders->ptrSize);
+        uint64_t count = (status == CDSpanStatusOK) ? CDReadPointer(_decoders, &cursor) : 0;
         CDLogInfo_HEX(@"protocol count", count);
         if (count == 0 && self.machOFile.chainedFixups) {
             CDLogInfo(@"didnt find the address, try lookup");
-            count = [self.machOFile.chainedFixups rebaseTargetFromAddress:address];
-            if (count == 0){
+            uint64_t based = [self.machOFile.chainedFixups rebaseTargetFromAddress:address];
+            if (based == 0){
                 CDLogInfo(@"failed!");
             } else {
-                CDLogInfo_HEX(@"protocolAddressListAtAddress based", count);
-                [cursor setAddress:count];
-                count = [cursor readPtr];
+                CDLogInfo_HEX(@"protocolAddressListAtAddress based", based);
+                status = CDSpanCursorSeekAddress(&cursor, self.machOFile, based, _decoders->ptrSize);
+                count = (status == CDSpanStatusOK) ? CDReadPointer(_decoders, &cursor) : 0;
             }
         }
+        if (count != 0 && (status = CDSpanCursorExtend(&cursor, count, _decoders->ptrSize)) != CDSpanStatusOK) {
+            CDLog(@"Warning: Couldn't read %llu protocol addresses at %016llx: %@", count, address, CDSpanStatusDescription(status));
+            count = 0;
+        }
         for (uint64_t index = 0; index < count; index++) {
-            uint64_t val = [cursor readPtr];
+            uint64_t val = CDReadPointer(_decoders, &cursor);
             if (val == 0) {
                 CDLog(@"Warning: protocol address in protocol list was 0.");
             } else {
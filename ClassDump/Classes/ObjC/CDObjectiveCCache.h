@@ -0,0 +1,48 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+
+@class CDClassDumpConfiguration, CDMachOFile, CDObjectiveCProcessor;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t rejected;  // Present, but truncated, corrupt or from another format version
+    uint64_t stores;
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+} CDObjectiveCCacheStatistics;
+
+// Persistent cache of the classes, protocols and categories loaded from each image, so unchanged images don't have
+// to walk their __objc_* sections again.  Entries are files in the cache directory, named by the image's LC_UUID,
+// its architecture and a hash of the configuration options that affect loading, and are mapped back in when they're
+// read.  Images without a UUID aren't cached.  Safe to use from multiple threads.
+//
+// The structure and union tables span every loaded image, so they aren't cached.  They're rebuilt from the cached
+// types, which is cheap compared to loading.
+@interface CDObjectiveCCache : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithDirectory:(NSString *)directory configuration:(CDClassDumpConfiguration *)configuration;
+
+@property (readonly) NSString *directory;
+
+// The file the entry for this image would be in, or nil if the image can't be cached.
+- (nullable NSString *)pathForMachOFile:(CDMachOFile *)machOFile;
+
+// Fills in a newly created processor from the cache.  Returns NO on a miss, leaving the processor untouched.
+- (BOOL)loadProcessor:(CDObjectiveCProcessor *)processor;
+// Saves the results of a processor that has finished processing.
+- (void)storeProcessor:(CDObjectiveCProcessor *)processor;
+
+@property (readonly) CDObjectiveCCacheStatistics statistics;
+- (NSString *)statisticsDescription;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,623 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDObjectiveCCache.h>
+
+#import <ClassDump/CDClassDumpConfiguration.h>
+#import <ClassDump/CDDataCursor.h>
+#import <ClassDump/CDMachOFile.h>
+#import <ClassDump/CDMappedData.h>
+#import <ClassDump/CDObjectiveCProcessor.h>
+#import <ClassDump/CDOCCategory.h>
+#import <ClassDump/CDOCClass.h>
+#import <ClassDump/CDOCClassReference.h>
+#import <ClassDump/CDOCInstanceVariable.h>
+#import <ClassDump/CDOCMethod.h>
+#import <ClassDump/CDOCProperty.h>
+#import <ClassDump/CDOCProtocol.h>
+#import <ClassDump/CDProtocolUniquer.h>
+#import <ClassDump/CDLCSymbolTable.h>
+#import <ClassDump/CDSymbol.h>
+#import <ClassDump/NSData-CDExtensions.h>
+#import <ClassDump/NSString-CDExtensions.h>
+#import <ClassDump/ClassDumpUtils.h>
+
+#include <os/lock.h>
+
+// Entry layout, all integers little endian:
+//   header:     uint32 magic, uint32 version, 16 byte UUID, uint64 configuration hash, uint32 length + UTF-8 arch name
+//   strings:    uint32 count, then uint32 length + UTF-8 bytes for each
+//   protocols:  uint32 count, then each protocol
+//   classes:    uint32 count, then each class
+//   categories: uint32 count, then each category
+// Everything after the string table refers to strings by index, CDObjectiveCCacheNoString for nil.  Bump the version
+// whenever the layout or the meaning of anything in it changes, old entries are then rejected and replaced.
+
+static const uint32_t CDObjectiveCCacheMagic     = 0x434f4443; // 'CDOC'
+static const uint32_t CDObjectiveCCacheVersion   = 3;
+static const uint32_t CDObjectiveCCacheNoString  = UINT32_MAX;
+
+// The configuration options that change what's loaded from an image, and so what an entry holds.  None of the current
+// ones do: sorting, stripping and formatting are applied when the headers are written, and the parallelism and file
+// loading options don't change the result.  When an option that does is added, append it here and bump the version.
+static const uint32_t CDObjectiveCCacheConfigurationVersion = 1;
+
+static NSString *CDObjectiveCCacheConfigurationKey(CDClassDumpConfiguration *configuration)
+{
+    NSMutableString *key = [NSMutableString stringWithFormat:@"configuration=%u", CDObjectiveCCacheConfigurationVersion];
+    return key;
+}
+
+typedef NS_ENUM(uint8_t, CDObjectiveCCacheClassReference) {
+    CDObjectiveCCacheClassReference_None     = 0,
+    CDObjectiveCCacheClassReference_Class    = 1, // uint32 index of a class in this entry
+    CDObjectiveCCacheClassReference_External = 2, // name, resolved against the image's symbol table on load
+    CDObjectiveCCacheClassReference_Internal = 3, // name, defined in this image but not one of its loaded classes
+};
+
+enum {
+    CDObjectiveCCacheClassFlag_Exported = 1 << 0,
+    CDObjectiveCCacheClassFlag_Swift    = 1 << 1,
+};
+
+#pragma mark - Encoding
+
+@interface CDObjectiveCCacheEncoder : NSObject
+@property (readonly) NSMutableData *body;
+- (NSData *)dataWithHeader:(NSData *)header;
+@end
+
+@implementation CDObjectiveCCacheEncoder
+{
+    NSMutableData *_body;
+    NSMutableArray<NSString *> *_strings;
+    NSMutableDictionary<NSString *, NSNumber *> *_stringIndexes;
+}
+
+- (instancetype)init;
+{
+    if ((self = [super init])) {
+        _body = [[NSMutableData alloc] init];
+        _strings = [[NSMutableArray alloc] init];
+        _stringIndexes = [[NSMutableDictionary alloc] init];
+    }
+
+    return self;
+}
+
+- (void)encodeUInt8:(uint8_t)value;
+{
+    [_body appendBytes:&value length:sizeof(value)];
+}
+
+- (void)encodeUInt32:(uint32_t)value;
+{
+    value = OSSwapHostToLittleInt32(value);
+    [_body appendBytes:&value length:sizeof(value)];
+}
+
+- (void)encodeUInt64:(uint64_t)value;
+{
+    value = OSSwapHostToLittleInt64(value);
+    [_body appendBytes:&value length:sizeof(value)];
+}
+
+- (void)encodeString:(NSString *)string;
+{
+    if (string == nil) {
+        [self encodeUInt32:CDObjectiveCCacheNoString];
+        return;
+    }
+
+    NSNumber *index = _stringIndexes[string];
+    if (index == nil) {
+        index = @([_strings count]);
+        [_strings addObject:string];
+        _stringIndexes[string] = index;
+    }
+    [self encodeUInt32:[index unsignedIntValue]];
+}
+
+- (void)encodeMethods:(id<NSFastEnumeration>)methods count:(NSUInteger)count;
+{
+    [self encodeUInt32:(uint32_t)count];
+    for (CDOCMethod *method in methods) {
+        [self encodeString:method.name];
+        [self encodeString:method.typeString];
+        [self encodeUInt64:method.address];
+        [self encodeUInt64:method.size];
+    }
+}
+
+- (void)encodeProtocolContents:(CDOCProtocol *)protocol;
+{
+    NSArray<NSString *> *protocolNames = protocol.protocolNames;
+    [self encodeUInt32:(uint32_t)[protocolNames count]];
+    for (NSString *name in protocolNames)
+        [self encodeString:name];
+
+    [self encodeMethods:protocol.classMethods count:[protocol.classMethods count]];
+    [self encodeMethods:protocol.instanceMethods count:[protocol.instanceMethods count]];
+    [self encodeMethods:protocol.optionalClassMethods count:[protocol.optionalClassMethods count]];
+    [self encodeMethods:protocol.optionalInstanceMethods count:[protocol.optionalInstanceMethods count]];
+
+    [self encodeUInt32:(uint32_t)[protocol.properties count]];
+    for (CDOCProperty *property in protocol.properties) {
+        [self encodeString:property.name];
+        [self encodeString:property.attributeString];
+        [self encodeUInt8:property.isClass];
+    }
+}
+
+- (void)encodeClassReference:(CDOCClassReference *)classRef classIndexes:(NSMapTable *)classIndexes;
+{
+    if (classRef == nil) {
+        [self encodeUInt8:CDObjectiveCCacheClassReference_None];
+    } else if (classRef.classObject != nil && NSMapMember(classIndexes, (__bridge const void *)classRef.classObject, NULL, NULL)) {
+        [self encodeUInt8:CDObjectiveCCacheClassReference_Class];
+        [self encodeUInt32:(uint32_t)(uintptr_t)NSMapGet(classIndexes, (__bridge const void *)classRef.classObject)];
+    } else {
+        [self encodeUInt8:classRef.isExternalClass ? CDObjectiveCCacheClassReference_External : CDObjectiveCCacheClassReference_Internal];
+        [self encodeString:classRef.className];
+    }
+}
+
+- (void)encodeProcessor:(CDObjectiveCProcessor *)processor;
+{
+    NSArray<CDOCProtocol *> *protocols = [processor.protocolUniquer uniqueProtocolsSortedByName];
+    NSArray<CDOCClass *> *classes = processor.classes;
+    NSArray<CDOCCategory *> *categories = processor.categories;
+
+    [self encodeUInt32:(uint32_t)[protocols count]];
+    for (CDOCProtocol *protocol in protocols) {
+        [self encodeString:protocol.name];
+        [self encodeProtocolContents:protocol];
+    }
+
+    NSMapTable *classIndexes = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                                         valueOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality
+                                                             capacity:[classes count]];
+    [classes enumerateObjectsUsingBlock:^(CDOCClass *aClass, NSUInteger index, BOOL *stop) {
+        NSMapInsert(classIndexes, (__bridge const void *)aClass, (const void *)index);
+    }];
+
+    [self encodeUInt32:(uint32_t)[classes count]];
+    for (CDOCClass *aClass in classes) {
+        [self encodeString:aClass.name];
+        [self encodeUInt8:(aClass.isExported ? CDObjectiveCCacheClassFlag_Exported : 0) | (aClass.isSwiftClass ? CDObjectiveCCacheClassFlag_Swift : 0)];
+        [self encodeClassReference:aClass.superClassRef classIndexes:classIndexes];
+        [self encodeUInt32:(uint32_t)[aClass.instanceVariables count]];
+        for (CDOCInstanceVariable *instanceVariable in aClass.instanceVariables) {
+            [self encodeString:instanceVariable.name];
+            [self encodeString:instanceVariable.typeString];
+            [self encodeUInt64:instanceVariable.offset];
+        }
+        [self encodeProtocolContents:aClass];
+    }
+
+    [self encodeUInt32:(uint32_t)[categories count]];
+    for (CDOCCategory *category in categories) {
+        [self encodeString:category.name];
+        [self encodeClassReference:category.classRef classIndexes:classIndexes];
+        [self encodeProtocolContents:category];
+    }
+}
+
+- (NSData *)dataWithHeader:(NSData *)header;
+{
+    NSMutableData *data = [header mutableCopy];
+
+    uint32_t count = OSSwapHostToLittleInt32((uint32_t)[_strings count]);
+    [data appendBytes:&count length:sizeof(count)];
+    for (NSString *string in _strings) {
+        NSData *bytes = [string dataUsingEncoding:NSUTF8StringEncoding];
+        uint32_t length = OSSwapHostToLittleInt32((uint32_t)[bytes length]);
+        [data appendBytes:&length length:sizeof(length)];
+        [data appendData:bytes];
+    }
+
+    [data appendData:_body];
+
+    return data;
+}
+
+@end
+
+#pragma mark - Decoding
+
+// Reading past the end of the entry raises NSRangeException, so does a bad string or class index.
+@interface CDObjectiveCCacheDecoder : NSObject
+- (instancetype)initWithCursor:(CDDataCursor *)cursor symbolTable:(CDLCSymbolTable *)symbolTable;
+@end
+
+@implementation CDObjectiveCCacheDecoder
+{
+    CDDataCursor *_cursor;
+    CDLCSymbolTable *_symbolTable;
+    NSMutableArray<NSString *> *_strings;
+}
+
+- (instancetype)initWithCursor:(CDDataCursor *)cursor symbolTable:(CDLCSymbolTable *)symbolTable;
+{
+    if ((self = [super init])) {
+        _cursor = cursor;
+        _symbolTable = symbolTable;
+        _strings = [[NSMutableArray alloc] init];
+    }
+
+    return self;
+}
+
+- (void)decodeStringTable;
+{
+    uint32_t count = [_cursor readLittleInt32];
+    for (uint32_t index = 0; index < count; index++) {
+        uint32_t length = [_cursor readLittleInt32];
+        NSString *string = [_cursor readStringOfLength:length encoding:NSUTF8StringEncoding];
+        if (string == nil)
+            [NSException raise:NSRangeException format:@"Invalid string %u in cache entry", index];
+        [_strings addObject:string];
+    }
+}
+
+- (NSString *)decodeString;
+{
+    uint32_t index = [_cursor readLittleInt32];
+    if (index == CDObjectiveCCacheNoString)
+        return nil;
+
+    return _strings[index]; // Raises NSRangeException if out of bounds
+}
+
+- (uint32_t)decodeCount;
+{
+    uint32_t count = [_cursor readLittleInt32];
+    if (count > [_cursor remaining])
+        [NSException raise:NSRangeException format:@"Invalid count %u in cache entry", count];
+
+    return count;
+}
+
+- (NSArray<CDOCMethod *> *)decodeMethods;
+{
+    uint32_t count = [self decodeCount];
+    NSMutableArray<CDOCMethod *> *methods = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t index = 0; index < count; index++) {
+        NSString *name = [self decodeString];
+        NSString *typeString = [self decodeString];
+        CDOCMethod *method = [[CDOCMethod alloc] initWithName:name typeString:typeString address:(NSUInteger)[_cursor readLittleInt64]];
+        method.size = (NSUInteger)[_cursor readLittleInt64];
+        [methods addObject:method];
+    }
+
+    return methods;
+}
+
+// Returns the names of the adopted protocols, which are resolved once all the protocols exist.
+- (NSArray<NSString *> *)decodeProtocolContents:(CDOCProtocol *)protocol;
+{
+    uint32_t count = [self decodeCount];
+    NSMutableArray<NSString *> *protocolNames = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t index = 0; index < count; index++) {
+        NSString *name = [self decodeString];
+        if (name != nil)
+            [protocolNames addObject:name];
+    }
+
+    for (CDOCMethod *method in [self decodeMethods])
+        [protocol addClassMethod:method];
+    for (CDOCMethod *method in [self decodeMethods])
+        [protocol addInstanceMethod:method];
+    for (CDOCMethod *method in [self decodeMethods])
+        [protocol addOptionalClassMethod:method];
+    for (CDOCMethod *method in [self decodeMethods])
+        [protocol addOptionalInstanceMethod:method];
+
+    count = [self decodeCount];
+    for (uint32_t index = 0; index < count; index++) {
+        NSString *name = [self decodeString];
+        NSString *attributes = [self decodeString];
+        BOOL isClass = [_cursor readByte] != 0;
+        [protocol addProperty:[[CDOCProperty alloc] initWithName:name attributes:attributes isClass:isClass]];
+    }
+
+    return protocolNames;
+}
+
+// Class references to other classes in the entry are returned as an NSNumber index, to be resolved once all of the
+// classes exist.
+- (id)decodeClassReference;
+{
+    uint8_t kind = [_cursor readByte];
+    switch (kind) {
+        case CDObjectiveCCacheClassReference_None:     return nil;
+        case CDObjectiveCCacheClassReference_Class:    return @([_cursor readLittleInt32]);
+        case CDObjectiveCCacheClassReference_External: return [self externalClassReferenceWithName:[self decodeString]];
+        case CDObjectiveCCacheClassReference_Internal: return [[CDOCClassReference alloc] initWithClassName:[self decodeString] external:NO];
+    }
+
+    [NSException raise:NSRangeException format:@"Invalid class reference kind %u in cache entry", kind];
+    return nil;
+}
+
+// The same as a fresh load, the symbol is what ties the class to the framework it's imported from.
+- (CDOCClassReference *)externalClassReferenceWithName:(NSString *)name;
+{
+    CDSymbol *classSymbol = name != nil ? [_symbolTable symbolForExternalClassName:name] : nil;
+    if (classSymbol != nil)
+        return [[CDOCClassReference alloc] initWithClassSymbol:classSymbol];
+
+    return [[CDOCClassReference alloc] initWithClassName:name external:YES];
+}
+
+- (CDOCClassReference *)resolveClassReference:(id)reference classes:(NSArray<CDOCClass *> *)classes;
+{
+    if ([reference isKindOfClass:[NSNumber class]])
+        return [[CDOCClassReference alloc] initWithClassObject:classes[[reference unsignedIntegerValue]]];
+
+    return reference;
+}
+
+// Fills in the processor.  Nothing is changed if this raises.
+- (void)decodeIntoProcessor:(CDObjectiveCProcessor *)processor;
+{
+    [self decodeStringTable];
+
+    uint32_t count = [self decodeCount];
+    NSMutableArray<CDOCProtocol *> *protocols = [NSMutableArray arrayWithCapacity:count];
+    NSMutableArray<NSArray<NSString *> *> *protocolAdoptedNames = [NSMutableArray arrayWithCapacity:count];
+    NSMutableDictionary<NSString *, CDOCProtocol *> *protocolsByName = [NSMutableDictionary dictionary];
+    for (uint32_t index = 0; index < count; index++) {
+        CDOCProtocol *protocol = [[CDOCProtocol alloc] init];
+        protocol.name = [self decodeString];
+        [protocolAdoptedNames addObject:[self decodeProtocolContents:protocol]];
+        [protocols addObject:protocol];
+        if (protocol.name != nil)
+            protocolsByName[protocol.name] = protocol;
+    }
+
+    count = [self decodeCount];
+    NSMutableArray<CDOCClass *> *classes = [NSMutableArray arrayWithCapacity:count];
+    NSMutableArray *superClassRefs = [NSMutableArray arrayWithCapacity:count];
+    NSMutableArray<NSArray<NSString *> *> *classAdoptedNames = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t index = 0; index < count; index++) {
+        CDOCClass *aClass = [[CDOCClass alloc] init];
+        aClass.name = [self decodeString];
+        uint8_t flags = [_cursor readByte];
+        aClass.isExported = (flags & CDObjectiveCCacheClassFlag_Exported) != 0;
+        aClass.isSwiftClass = (flags & CDObjectiveCCacheClassFlag_Swift) != 0;
+        id superClassRef = [self decodeClassReference];
+        [superClassRefs addObject:superClassRef != nil ? superClassRef : [NSNull null]];
+
+        uint32_t ivarCount = [self decodeCount];
+        NSMutableArray<CDOCInstanceVariable *> *instanceVariables = [NSMutableArray arrayWithCapacity:ivarCount];
+        for (uint32_t ivarIndex = 0; ivarIndex < ivarCount; ivarIndex++) {
+            NSString *name = [self decodeString];
+            NSString *typeString = [self decodeString];
+            [instanceVariables addObject:[[CDOCInstanceVariable alloc] initWithName:name typeString:typeString offset:(NSUInteger)[_cursor readLittleInt64]]];
+        }
+        aClass.instanceVariables = instanceVariables;
+
+        [classAdoptedNames addObject:[self decodeProtocolContents:aClass]];
+        [classes addObject:aClass];
+    }
+
+    [classes enumerateObjectsUsingBlock:^(CDOCClass *aClass, NSUInteger index, BOOL *stop) {
+        if (superClassRefs[index] != [NSNull null])
+            aClass.superClassRef = [self resolveClassReference:superClassRefs[index] classes:classes];
+    }];
+
+    count = [self decodeCount];
+    NSMutableArray<CDOCCategory *> *categories = [NSMutableArray arrayWithCapacity:count];
+    NSMutableArray<NSArray<NSString *> *> *categoryAdoptedNames = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t index = 0; index < count; index++) {
+        CDOCCategory *category = [[CDOCCategory alloc] init];
+        category.name = [self decodeString];
+        category.classRef = [self resolveClassReference:[self decodeClassReference] classes:classes];
+        [categoryAdoptedNames addObject:[self decodeProtocolContents:category]];
+        [categories addObject:category];
+    }
+
+    // Everything decoded, now it's safe to change the processor.  The protocols go through the uniquer, the same way
+    // freshly loaded ones do, and everything else adopts the uniqued instances.
+    CDProtocolUniquer *protocolUniquer = processor.protocolUniquer;
+    [protocols enumerateObjectsUsingBlock:^(CDOCProtocol *protocol, NSUInteger index, BOOL *stop) {
+        for (NSString *name in protocolAdoptedNames[index]) {
+            CDOCProtocol *adoptedProtocol = protocolsByName[name];
+            if (adoptedProtocol != nil)
+                [protocol addProtocol:adoptedProtocol];
+        }
+        [protocolUniquer setProtocol:protocol withAddress:index + 1];
+    }];
+    [protocolUniquer createUniquedProtocols];
+
+    NSMutableDictionary<NSString *, CDOCProtocol *> *uniqueProtocolsByName = [NSMutableDictionary dictionary];
+    for (CDOCProtocol *protocol in [protocolUniquer uniqueProtocolsSortedByName])
+        uniqueProtocolsByName[protocol.name] = protocol;
+
+    void (^addProtocols)(CDOCProtocol *, NSArray<NSString *> *) = ^(CDOCProtocol *adopter, NSArray<NSString *> *names) {
+        for (NSString *name in names) {
+            CDOCProtocol *protocol = uniqueProtocolsByName[name];
+            if (protocol == nil) {
+                protocol = [[CDOCProtocol alloc] init];
+                protocol.name = name;
+                uniqueProtocolsByName[name] = protocol;
+            }
+            [adopter addProtocol:protocol];
+        }
+    };
+
+    [classes enumerateObjectsUsingBlock:^(CDOCClass *aClass, NSUInteger index, BOOL *stop) {
+        addProtocols(aClass, classAdoptedNames[index]);
+    }];
+    [categories enumerateObjectsUsingBlock:^(CDOCCategory *category, NSUInteger index, BOOL *stop) {
+        addProtocols(category, categoryAdoptedNames[index]);
+    }];
+
+    [processor addClassesFromArray:classes];
+    [processor addCategoriesFromArray:categories];
+}
+
+@end
+
+#pragma mark -
+
+@implementation CDObjectiveCCache
+{
+    NSString *_directory;
+    uint64_t _configurationHash;
+
+    os_unfair_lock _lock;
+    CDObjectiveCCacheStatistics _statistics;
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory configuration:(CDClassDumpConfiguration *)configuration;
+{
+    if ((self = [super init])) {
+        _directory = [directory copy];
+        _lock = OS_UNFAIR_LOCK_INIT;
+
+        _configurationHash = CDObjectiveCCacheConfigurationKey(configuration).FNV1aHash;
+    }
+
+    return self;
+}
+
+#pragma mark -
+
+- (NSString *)pathForMachOFile:(CDMachOFile *)machOFile;
+{
+    NSUUID *UUID = machOFile.UUID;
+    if (UUID == nil)
+        return nil;
+
+    NSString *filename = [NSString stringWithFormat:@"%@-%@-%016llx.cdcache", UUID.UUIDString, machOFile.archName, _configurationHash];
+    return [_directory stringByAppendingPathComponent:filename];
+}
+
+- (NSData *)headerForMachOFile:(CDMachOFile *)machOFile;
+{
+    NSMutableData *header = [NSMutableData data];
+
+    uint32_t magic = OSSwapHostToLittleInt32(CDObjectiveCCacheMagic);
+    uint32_t version = OSSwapHostToLittleInt32(CDObjectiveCCacheVersion);
+    [header appendBytes:&magic length:sizeof(magic)];
+    [header appendBytes:&version length:sizeof(version)];
+
+    uuid_t uuid;
+    [machOFile.UUID getUUIDBytes:uuid];
+    [header appendBytes:uuid length:sizeof(uuid)];
+
+    uint64_t configurationHash = OSSwapHostToLittleInt64(_configurationHash);
+    [header appendBytes:&configurationHash length:sizeof(configurationHash)];
+
+    NSData *archName = [machOFile.archName dataUsingEncoding:NSUTF8StringEncoding];
+    uint32_t length = OSSwapHostToLittleInt32((uint32_t)[archName length]);
+    [header appendBytes:&length length:sizeof(length)];
+    [header appendData:archName];
+
+    return header;
+}
+
+- (BOOL)loadProcessor:(CDObjectiveCProcessor *)processor;
+{
+    CDMachOFile *machOFile = processor.machOFile;
+    NSString *path = [self pathForMachOFile:machOFile];
+    if (path == nil)
+        return NO;
+
+    NSError *error = nil;
+    CDMappedData *data = [CDMappedData dataWithContentsOfFile:path loadingMode:CDFileLoadingModeMapped error:&error];
+    if (data == nil) {
+        os_unfair_lock_lock(&_lock);
+        _statistics.misses++;
+        os_unfair_lock_unlock(&_lock);
+        return NO;
+    }
+    [data adviseAccess:CDMappedDataAccessSequential range:NSMakeRange(0, [data length])];
+
+    // Compare the whole header, the filename alone could be a collision or a stale format.
+    NSData *expectedHeader = [self headerForMachOFile:machOFile];
+    BOOL isValid = [data length] >= [expectedHeader length] && memcmp([data bytes], [expectedHeader bytes], [expectedHeader length]) == 0;
+    if (isValid) {
+        CDDataCursor *cursor = [[CDDataCursor alloc] initWithData:data];
+        cursor.offset = [expectedHeader length];
+        // External class references are resolved against the symbols, like processing does.
+        if (machOFile.isEncrypted == NO && machOFile.canDecryptAllSegments)
+            [machOFile.symbolTable loadSymbols];
+        CDObjectiveCCacheDecoder *decoder = [[CDObjectiveCCacheDecoder alloc] initWithCursor:cursor symbolTable:machOFile.symbolTable];
+        @try {
+            [decoder decodeIntoProcessor:processor];
+        } @catch (NSException *exception) {
+            if ([exception.name isEqualToString:NSRangeException] == NO)
+                @throw;
+            CDLogWarning(@"Ignoring damaged cache entry %@: %@", path, exception.reason);
+            isValid = NO;
+        }
+    }
+
+    os_unfair_lock_lock(&_lock);
+    if (isValid) {
+        _statistics.hits++;
+        _statistics.bytesRead += [data length];
+    } else {
+        _statistics.rejected++;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (isValid)
+        CDLogVerbose(@"%@ loaded from cache %@", machOFile.importBaseName, path);
+
+    return isValid;
+}
+
+- (void)storeProcessor:(CDObjectiveCProcessor *)processor;
+{
+    CDMachOFile *machOFile = processor.machOFile;
+    NSString *path = [self pathForMachOFile:machOFile];
+    if (path == nil)
+        return;
+
+    CDObjectiveCCacheEncoder *encoder = [[CDObjectiveCCacheEncoder alloc] init];
+    [encoder encodeProcessor:processor];
+    NSData *data = [encoder dataWithHeader:[self headerForMachOFile:machOFile]];
+
+    NSError *error = nil;
+    if ([[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:&error] == NO
+        || [data writeToFile:path options:NSDataWritingAtomic error:&error] == NO) {
+        CDLogWarning(@"Couldn't write cache entry %@: %@", path, error);
+        return;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    _statistics.stores++;
+    _statistics.bytesWritten += [data length];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (CDObjectiveCCacheStatistics)statistics;
+{
+    os_unfair_lock_lock(&_lock);
+    CDObjectiveCCacheStatistics statistics = _statistics;
+    os_unfair_lock_unlock(&_lock);
+
+    return statistics;
+}
+
+- (NSString *)statisticsDescription;
+{
+    CDObjectiveCCacheStatistics statistics = self.statistics;
+    return [NSString stringWithFormat:@"cache: %llu hits (%llu bytes), %llu misses, %llu rejected, %llu stored (%llu bytes)",
+            statistics.hits, statistics.bytesRead, statistics.misses, statistics.rejected, statistics.stores, statistics.bytesWritten];
+}
+
+#pragma mark - Debugging
+
+- (NSString *)description;
+{
+    return [NSString stringWithFormat:@"<%@:%p> directory: %@, %@", NSStringFromClass([self class]), self, _directory, [self statisticsDescription]];
+}
+
+@end
@@ -12,6 +12,8 @@
 @property (weak, readonly) CDMachOFile *machOFile;
 @property (readonly) BOOL hasObjectiveCData;
 //@property (assign) BOOL shallow;
+// Load the classes, protocols and categories of large images on all cores.  The results are in section order either way.
+@property (assign) BOOL loadsInParallel;
 
 @property (readonly) CDSection *objcImageInfoSection;
 @property (readonly) NSString *garbageCollectionStatus;
@@ -19,6 +21,9 @@
 
 - (instancetype)initWithMachOFile:(CDMachOFile *)machOFile;
 
+@property (readonly) NSArray<CDOCClass *> *classes;
+@property (readonly) NSArray<CDOCCategory *> *categories;
+
 - (void)addClass:(CDOCClass *)aClass withAddress:(uint64_t)address;
 - (void)addClassesFromArray:(NSArray<CDOCClass *> *)array;
 - (void)addCategoriesFromArray:(NSArray<CDOCCategory *> *)array;
@@ -30,6 +35,8 @@
 - (void)loadClasses;
 - (void)loadCategories;
 
+// Only touches this image's own objects, so different images can parse their types at the same time.
+- (void)parseTypes;
 - (void)registerTypesWithObject:(CDTypeController *)typeController phase:(NSUInteger)phase;
 - (void)recursivelyVisit:(CDVisitor *)visitor;
 
@@ -104,6 +104,16 @@
 
 #pragma mark -
 
+- (NSArray<CDOCClass *> *)classes;
+{
+    return [_classes copy];
+}
+
+- (NSArray<CDOCCategory *> *)categories;
+{
+    return [_categories copy];
+}
+
 - (void)addClass:(CDOCClass *)aClass withAddress:(uint64_t)address;
 {
     [_classes addObject:aClass];
@@ -196,6 +206,18 @@
 }
 
 
+- (void)parseTypes;
+{
+    for (CDOCClass *aClass in _classes)
+        [aClass parseTypes];
+
+    for (CDOCCategory *category in _categories)
+        [category parseTypes];
+
+    for (CDOCProtocol *protocol in [self.protocolUniquer uniqueProtocolsSortedByName])
+        [protocol parseTypes];
+}
+
 - (void)registerTypesWithObject:(CDTypeController *)typeController phase:(NSUInteger)phase;
 {
     for (CDOCClass *aClass in _classes)
@@ -0,0 +1,29 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+
+@class CDLCSegment, CDSection;
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Immutable, sorted interval table of the segments and sections of a Mach-O file.  Built once after the load
+// commands are read; lookups are a binary search, with the last hit checked first since consecutive lookups
+// tend to land in the same section.  Safe to query from multiple threads.
+@interface CDAddressIndex : NSObject
+
+- (instancetype)initWithSegments:(NSArray<CDLCSegment *> *)segments;
+
+- (nullable CDLCSegment *)segmentWithName:(NSString *)name;
+- (nullable CDLCSegment *)segmentContainingAddress:(NSUInteger)address;
+- (nullable CDSection *)sectionContainingAddress:(NSUInteger)address;
+
+// Returns NSNotFound if no segment contains the address, and 0 if the address is in a segment but not in any
+// of its sections.
+- (NSUInteger)fileOffsetForAddress:(NSUInteger)address;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,203 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDAddressIndex.h>
+
+#include <stdatomic.h>
+#import <ClassDump/CDLCSegment.h>
+#import <ClassDump/CDSection.h>
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;       // Exclusive
+    uint64_t fileoff;   // Section file offset, unused for segments
+    uint32_t first;     // Segments: index of the first section entry
+    uint32_t count;     // Segments: number of section entries
+    __unsafe_unretained id object;
+} CDAddressRange;
+
+// Index of the range containing address, or -1.  Ranges must be sorted and non-overlapping.
+static NSInteger CDAddressRangeSearch(const CDAddressRange *ranges, NSUInteger count, uint64_t address)
+{
+    NSUInteger low = 0, high = count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (address < ranges[mid].start)     high = mid;
+        else if (address >= ranges[mid].end) low = mid + 1;
+        else                                 return (NSInteger)mid;
+    }
+    
+    return -1;
+}
+
+static int CDAddressRangeCompare(const void *a, const void *b)
+{
+    const CDAddressRange *lhs = a, *rhs = b;
+    if (lhs->start < rhs->start) return -1;
+    if (lhs->start > rhs->start) return 1;
+    return 0;
+}
+
+@implementation CDAddressIndex
+{
+    // Keeps the objects referenced from the range tables alive.
+    NSArray<CDLCSegment *> *_segments;
+    NSDictionary<NSString *, CDLCSegment *> *_segmentsByName;
+    
+    CDAddressRange *_segmentRanges;
+    NSUInteger _segmentCount;
+    CDAddressRange *_sectionRanges;
+    NSUInteger _sectionCount;
+    
+    _Atomic(NSUInteger) _lastSegment;
+    _Atomic(NSUInteger) _lastSection;
+}
+
+- (instancetype)initWithSegments:(NSArray<CDLCSegment *> *)segments;
+{
+    if ((self = [super init])) {
+        _segments = [segments copy];
+        
+        NSMutableDictionary *segmentsByName = [[NSMutableDictionary alloc] init];
+        NSUInteger sectionCapacity = 0;
+        for (CDLCSegment *segment in _segments) {
+            if (segment.name != nil && segmentsByName[segment.name] == nil)
+                segmentsByName[segment.name] = segment; // First one wins, same as the old linear scan
+            sectionCapacity += segment.sections.count;
+        }
+        _segmentsByName = [segmentsByName copy];
+        
+        _segmentRanges = calloc(MAX(_segments.count, 1), sizeof(CDAddressRange));
+        _sectionRanges = calloc(MAX(sectionCapacity, 1), sizeof(CDAddressRange));
+        
+        for (CDLCSegment *segment in _segments) {
+            if (segment.vmsize == 0)
+                continue;
+            
+            CDAddressRange *segmentRange = &_segmentRanges[_segmentCount++];
+            segmentRange->start  = segment.vmaddr;
+            segmentRange->end    = segment.vmaddr + segment.vmsize;
+            segmentRange->object = segment;
+            segmentRange->first  = (uint32_t)_sectionCount;
+            
+            for (CDSection *section in segment.sections) {
+                if (section.size == 0)
+                    continue;
+                
+                CDAddressRange *sectionRange = &_sectionRanges[_sectionCount++];
+                sectionRange->start   = section.addr;
+                sectionRange->end     = section.addr + section.size;
+                sectionRange->fileoff = section.offset;
+                sectionRange->object  = section;
+            }
+            
+            segmentRange->count = (uint32_t)(_sectionCount - segmentRange->first);
+            qsort(&_sectionRanges[segmentRange->first], segmentRange->count, sizeof(CDAddressRange), CDAddressRangeCompare);
+        }
+        
+        qsort(_segmentRanges, _segmentCount, sizeof(CDAddressRange), CDAddressRangeCompare);
+        
+        // Malformed files can have overlapping ranges.  Trim them so the table stays searchable; the earlier range wins.
+        for (NSUInteger index = 1; index < _segmentCount; index++) {
+            if (_segmentRanges[index].start < _segmentRanges[index - 1].end)
+                _segmentRanges[index - 1].end = _segmentRanges[index].start;
+        }
+        for (NSUInteger index = 0; index < _segmentCount; index++) {
+            CDAddressRange *sections = &_sectionRanges[_segmentRanges[index].first];
+            for (NSUInteger sectionIndex = 1; sectionIndex < _segmentRanges[index].count; sectionIndex++) {
+                if (sections[sectionIndex].start < sections[sectionIndex - 1].end)
+                    sections[sectionIndex - 1].end = sections[sectionIndex].start;
+            }
+        }
+        
+        atomic_init(&_lastSegment, 0);
+        atomic_init(&_lastSection, 0);
+    }
+    
+    return self;
+}
+
+- (void)dealloc;
+{
+    free(_segmentRanges);
+    free(_sectionRanges);
+}
+
+#pragma mark -
+
+- (CDLCSegment *)segmentWithName:(NSString *)name;
+{
+    return _segmentsByName[name];
+}
+
+- (const CDAddressRange *)segmentRangeContainingAddress:(uint64_t)address;
+{
+    if (_segmentCount == 0)
+        return NULL;
+    
+    NSUInteger last = atomic_load_explicit(&_lastSegment, memory_order_relaxed);
+    if (address >= _segmentRanges[last].start && address < _segmentRanges[last].end)
+        return &_segmentRanges[last];
+    
+    NSInteger index = CDAddressRangeSearch(_segmentRanges, _segmentCount, address);
+    if (index < 0)
+        return NULL;
+    
+    atomic_store_explicit(&_lastSegment, (NSUInteger)index, memory_order_relaxed);
+    return &_segmentRanges[index];
+}
+
+- (const CDAddressRange *)sectionRangeContainingAddress:(uint64_t)address;
+{
+    if (_sectionCount == 0)
+        return NULL;
+    
+    NSUInteger last = atomic_load_explicit(&_lastSection, memory_order_relaxed);
+    if (address >= _sectionRanges[last].start && address < _sectionRanges[last].end)
+        return &_sectionRanges[last];
+    
+    const CDAddressRange *segmentRange = [self segmentRangeContainingAddress:address];
+    if (segmentRange == NULL)
+        return NULL;
+    
+    NSInteger index = CDAddressRangeSearch(&_sectionRanges[segmentRange->first], segmentRange->count, address);
+    if (index < 0)
+        return NULL;
+    
+    index += segmentRange->first;
+    atomic_store_explicit(&_lastSection, (NSUInteger)index, memory_order_relaxed);
+    return &_sectionRanges[index];
+}
+
+- (CDLCSegment *)segmentContainingAddress:(NSUInteger)address;
+{
+    const CDAddressRange *range = [self segmentRangeContainingAddress:address];
+    return range != NULL ? range->object : nil;
+}
+
+- (CDSection *)sectionContainingAddress:(NSUInteger)address;
+{
+    const CDAddressRange *range = [self sectionRangeContainingAddress:address];
+    return range != NULL ? range->object : nil;
+}
+
+- (NSUInteger)fileOffsetForAddress:(NSUInteger)address;
+{
+    const CDAddressRange *range = [self sectionRangeContainingAddress:address];
+    if (range != NULL)
+        return (NSUInteger)(range->fileoff + address - range->start);
+    
+    return [self segmentRangeContainingAddress:address] != NULL ? 0 : NSNotFound;
+}
+
+#pragma mark - Debugging
+
+- (NSString *)description;
+{
+    return [NSString stringWithFormat:@"<%@:%p> segments: %lu, sections: %lu",
+            NSStringFromClass([self class]), self, _segmentCount, _sectionCount];
+}
+
+@end
@@ -9,9 +9,11 @@
 
 @interface CDProtocolUniquer : NSObject
 
-// Gather
+// Gather, safe to call from multiple threads
 - (CDOCProtocol *)protocolWithAddress:(uint64_t)address;
 - (void)setProtocol:(CDOCProtocol *)protocol withAddress:(uint64_t)address;
+// Returns the protocol already gathered at the address, or nil after gathering this one.
+- (CDOCProtocol *)protocolWithAddress:(uint64_t)address orSetProtocol:(CDOCProtocol *)protocol;
 
 // Process
 - (void)createUniquedProtocols;
@@ -31,13 +31,28 @@
 - (CDOCProtocol *)protocolWithAddress:(uint64_t)address;
 {
     NSNumber *key = [NSNumber numberWithUnsignedLongLong:address];
-    return _protocolsByAddress[key];
+    @synchronized (self) {
+        return _protocolsByAddress[key];
+    }
 }
 
 - (void)setProtocol:(CDOCProtocol *)protocol withAddress:(uint64_t)address;
 {
     NSNumber *key = [NSNumber numberWithUnsignedLongLong:address];
-    _protocolsByAddress[key] = protocol;
+    @synchronized (self) {
+        _protocolsByAddress[key] = protocol;
+    }
+}
+
+- (CDOCProtocol *)protocolWithAddress:(uint64_t)address orSetProtocol:(CDOCProtocol *)protocol;
+{
+    NSNumber *key = [NSNumber numberWithUnsignedLongLong:address];
+    @synchronized (self) {
+        CDOCProtocol *existingProtocol = _protocolsByAddress[key];
+        if (existingProtocol == nil)
+            _protocolsByAddress[key] = protocol;
+        return existingProtocol;
+    }
 }
 
 #pragma mark - Process
@@ -5,6 +5,14 @@
 
 #import <Foundation/Foundation.h>
 
+typedef struct {
+    uint64_t lookups;
+    uint64_t hits;             // Answered from the resolution cache, found or not
+    uint64_t negativeHits;     // Of those, names known not to exist in any of the search paths
+    uint64_t existenceChecks;  // Candidate paths looked at
+    uint64_t fileSystemChecks; // Of those, the ones that actually went to the file system
+} CDSearchPathStatistics;
+
 @interface CDSearchPathState : NSObject
 
 @property (nonatomic, strong) NSString *executablePath;
@@ -14,4 +22,12 @@
 
 - (NSArray<NSArray<id> *> *)searchPaths;
 
+// Resolves an @rpath install name against searchPaths, in order.  Results are cached by (name, search paths),
+// misses included, and every candidate path is only checked on disk once.  Returns nil if no candidate exists.
+// Safe to use from multiple threads.
+- (NSString *)resolvedPathForRunPathName:(NSString *)name searchPaths:(NSArray<NSString *> *)searchPaths;
+
+@property (readonly) CDSearchPathStatistics statistics;
+- (NSString *)statisticsDescription;
+
 @end
@@ -6,21 +6,33 @@
 #import <ClassDump/CDSearchPathState.h>
 #import <ClassDump/ClassDumpUtils.h>
 
-@interface CDSearchPathState ()
-
-@property (nonatomic, strong, readonly) NSMutableArray<NSArray<id> *> *searchPathStack;
-
-@end
-
-#pragma mark -
+#include <os/lock.h>
 
 @implementation CDSearchPathState
+{
+    // The flattened search paths are kept up to date as groups are pushed and popped, with the size of each group
+    // on the side so a pop knows how much to remove.
+    NSMutableArray<NSString *> *_flattenedSearchPaths;
+    NSMutableArray<NSNumber *> *_groupCounts;
+    NSArray<NSString *> *_searchPathsSnapshot;
+
+    os_unfair_lock _lock;
+    NSMutableDictionary<NSString *, id> *_resolvedPathsByKey; // NSString, or NSNull for names that weren't found
+    NSMutableDictionary<NSString *, NSNumber *> *_pathExists;
+    CDSearchPathStatistics _statistics;
+}
 
 - (instancetype)init;
 {
     if ((self = [super init])) {
         _executablePath = nil;
-        _searchPathStack = [[NSMutableArray alloc] init];
+        _flattenedSearchPaths = [[NSMutableArray alloc] init];
+        _groupCounts = [[NSMutableArray alloc] init];
+        _searchPathsSnapshot = @[];
+
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _resolvedPathsByKey = [[NSMutableDictionary alloc] init];
+        _pathExists = [[NSMutableDictionary alloc] init];
     }
 
     return self;
@@ -30,26 +42,109 @@
 
 - (void)pushSearchPaths:(NSArray *)searchPaths;
 {
-    [self.searchPathStack addObject:searchPaths];
+    @synchronized (self) {
+        [_flattenedSearchPaths addObjectsFromArray:searchPaths];
+        [_groupCounts addObject:@([searchPaths count])];
+        _searchPathsSnapshot = nil;
+    }
 }
 
 - (void)popSearchPaths;
 {
-    if ([self.searchPathStack count] > 0) {
-        [self.searchPathStack removeLastObject];
-    } else {
-        CDLog(@"Warning: Unbalanced popSearchPaths");
+    @synchronized (self) {
+        if ([_groupCounts count] > 0) {
+            NSUInteger count = [[_groupCounts lastObject] unsignedIntegerValue];
+            [_groupCounts removeLastObject];
+            [_flattenedSearchPaths removeObjectsInRange:NSMakeRange([_flattenedSearchPaths count] - count, count)];
+            _searchPathsSnapshot = nil;
+        } else {
+            CDLog(@"Warning: Unbalanced popSearchPaths");
+        }
     }
 }
 
 - (NSArray<NSArray<id> *> *)searchPaths;
 {
-    NSMutableArray *result = [NSMutableArray array];
-    for (NSArray *group in self.searchPathStack) {
-        [result addObjectsFromArray:group];
+    @synchronized (self) {
+        // Only copied again after the stack changes.
+        if (_searchPathsSnapshot == nil)
+            _searchPathsSnapshot = [_flattenedSearchPaths copy];
+
+        return (NSArray<NSArray<id> *> *)_searchPathsSnapshot;
+    }
+}
+
+#pragma mark - Resolving
+
+- (BOOL)fileExistsAtPath:(NSString *)path;
+{
+    os_unfair_lock_lock(&_lock);
+    NSNumber *exists = _pathExists[path];
+    _statistics.existenceChecks++;
+    if (exists == nil)
+        _statistics.fileSystemChecks++;
+    os_unfair_lock_unlock(&_lock);
+
+    if (exists == nil) {
+        // Another thread may check the same path at the same time, which only costs a duplicate stat.
+        exists = @([[NSFileManager defaultManager] fileExistsAtPath:path]);
+        os_unfair_lock_lock(&_lock);
+        _pathExists[path] = exists;
+        os_unfair_lock_unlock(&_lock);
     }
 
-    return [result copy];
+    return [exists boolValue];
+}
+
+- (NSString *)resolvedPathForRunPathName:(NSString *)name searchPaths:(NSArray<NSString *> *)searchPaths;
+{
+    NSString *rpathPrefix = @"@rpath";
+    NSString *key = [[searchPaths arrayByAddingObject:name] componentsJoinedByString:@"\n"];
+
+    os_unfair_lock_lock(&_lock);
+    id resolvedPath = _resolvedPathsByKey[key];
+    _statistics.lookups++;
+    if (resolvedPath != nil) {
+        _statistics.hits++;
+        if (resolvedPath == [NSNull null])
+            _statistics.negativeHits++;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (resolvedPath == nil) {
+        resolvedPath = [NSNull null];
+        for (NSString *searchPath in searchPaths) {
+            NSString *str = [name stringByReplacingOccurrencesOfString:rpathPrefix withString:searchPath];
+            if ([self fileExistsAtPath:str]) {
+                resolvedPath = str;
+                break;
+            }
+        }
+
+        os_unfair_lock_lock(&_lock);
+        _resolvedPathsByKey[key] = resolvedPath;
+        os_unfair_lock_unlock(&_lock);
+    }
+
+    return resolvedPath == [NSNull null] ? nil : resolvedPath;
+}
+
+- (CDSearchPathStatistics)statistics;
+{
+    os_unfair_lock_lock(&_lock);
+    CDSearchPathStatistics statistics = _statistics;
+    os_unfair_lock_unlock(&_lock);
+
+    return statistics;
+}
+
+- (NSString *)statisticsDescription;
+{
+    CDSearchPathStatistics statistics = self.statistics;
+    double hitRate = statistics.lookups > 0 ? 100.0 * statistics.hits / statistics.lookups : 0;
+    return [NSString stringWithFormat:@"run paths: %llu lookups, %llu hits (%.1f%%), %llu known missing, %llu candidate paths, %llu checked on disk",
+            statistics.lookups, statistics.hits, hitRate, statistics.negativeHits,
+            statistics.existenceChecks, statistics.fileSystemChecks];
 }
 
 @end
@@ -21,6 +21,7 @@
 
 @property (nonatomic, readonly) NSUInteger addr;
 @property (nonatomic, readonly) NSUInteger size;
+@property (nonatomic, readonly) NSUInteger offset; // File offset, 0 for zerofill sections
 
 - (BOOL)containsAddress:(NSUInteger)address;
 - (NSUInteger)fileOffsetForAddress:(NSUInteger)address;
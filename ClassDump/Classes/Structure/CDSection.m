@@ -58,7 +58,7 @@
 - (NSData *)data;
 {
     if (!_data) {
-        _data = [[NSData alloc] initWithBytes:(uint8_t *)[self.segment.machOFile.data bytes] + _section.offset length:_section.size];
+        _data = [self.segment.machOFile dataViewAtOffset:_section.offset length:_section.size];
     }
     return _data;
 }
@@ -73,6 +73,11 @@
     return _section.size;
 }
 
+- (NSUInteger)offset;
+{
+    return _section.offset;
+}
+
 - (BOOL)containsAddress:(NSUInteger)address;
 {
     return (address >= _section.addr) && (address < _section.addr + _section.size);
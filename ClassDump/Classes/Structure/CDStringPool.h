@@ -0,0 +1,35 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef struct {
+    uint64_t lookups;
+    uint64_t addressHits;   // Answered from the address cache without touching the file
+    uint64_t internHits;    // New address, but the same bytes were already pooled
+    uint64_t uniqueStrings;
+    uint64_t uniqueBytes;
+    uint64_t bytesSaved;    // String bytes that would have been allocated again without the pool
+} CDStringPoolStatistics;
+
+// Per-image cache of the C strings read out of a Mach-O file.  Results are cached by address, and identical
+// strings found at different addresses (the same selector referenced from many classes, say) share one
+// immutable NSString.  Safe to use from multiple threads.
+@interface CDStringPool : NSObject
+
+- (nullable NSString *)stringForAddress:(uint64_t)address;
+
+// Returns the pooled string for these bytes, remembering it for address.  Returns nil if the bytes can't be
+// decoded, in which case nothing is cached.
+- (nullable NSString *)internCString:(const char *)cString forAddress:(uint64_t)address;
+
+@property (readonly) CDStringPoolStatistics statistics;
+- (NSString *)statisticsDescription;
+
+@end
+
+NS_ASSUME_NONNULL_END
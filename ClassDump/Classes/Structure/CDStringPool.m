@@ -0,0 +1,103 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDStringPool.h>
+
+#include <os/lock.h>
+
+@implementation CDStringPool
+{
+    os_unfair_lock _lock;
+    NSMapTable<id, NSString *> *_stringsByAddress; // Integer keys
+    NSMutableSet<NSString *> *_strings;
+    CDStringPoolStatistics _statistics;
+}
+
+- (instancetype)init;
+{
+    if ((self = [super init])) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _stringsByAddress = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality
+                                                      valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPersonality
+                                                          capacity:0];
+        _strings = [[NSMutableSet alloc] init];
+    }
+
+    return self;
+}
+
+#pragma mark -
+
+- (NSString *)stringForAddress:(uint64_t)address;
+{
+    if (address == 0)
+        return nil;
+
+    os_unfair_lock_lock(&_lock);
+    NSString *string = (__bridge NSString *)NSMapGet(_stringsByAddress, (const void *)(uintptr_t)address);
+    _statistics.lookups++;
+    if (string != nil) {
+        _statistics.addressHits++;
+        _statistics.bytesSaved += [string length];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    return string;
+}
+
+- (NSString *)internCString:(const char *)cString forAddress:(uint64_t)address;
+{
+    NSUInteger length = strlen(cString);
+
+    // Probe without copying, the bytes are only copied if this turns out to be a new string.
+    NSString *probe = [[NSString alloc] initWithBytesNoCopy:(void *)cString length:length encoding:NSASCIIStringEncoding freeWhenDone:NO];
+    if (probe == nil)
+        return nil;
+
+    os_unfair_lock_lock(&_lock);
+    NSString *string = [_strings member:probe];
+    if (string != nil) {
+        _statistics.internHits++;
+        _statistics.bytesSaved += length;
+    } else {
+        string = [[NSString alloc] initWithBytes:cString length:length encoding:NSASCIIStringEncoding];
+        [_strings addObject:string];
+        _statistics.uniqueStrings++;
+        _statistics.uniqueBytes += length;
+    }
+    if (address != 0)
+        NSMapInsert(_stringsByAddress, (const void *)(uintptr_t)address, (__bridge const void *)string);
+    os_unfair_lock_unlock(&_lock);
+
+    return string;
+}
+
+- (CDStringPoolStatistics)statistics;
+{
+    os_unfair_lock_lock(&_lock);
+    CDStringPoolStatistics statistics = _statistics;
+    os_unfair_lock_unlock(&_lock);
+
+    return statistics;
+}
+
+- (NSString *)statisticsDescription;
+{
+    CDStringPoolStatistics statistics = self.statistics;
+    uint64_t hits = statistics.addressHits + statistics.internHits;
+    double hitRate = statistics.lookups > 0 ? 100.0 * hits / statistics.lookups : 0;
+    return [NSString stringWithFormat:@"strings: %llu lookups, %llu address hits, %llu intern hits (%.1f%%), %llu unique (%llu bytes), %llu bytes saved",
+            statistics.lookups, statistics.addressHits, statistics.internHits, hitRate,
+            statistics.uniqueStrings, statistics.uniqueBytes, statistics.bytesSaved];
+}
+
+#pragma mark - Debugging
+
+- (NSString *)description;
+{
+    return [NSString stringWithFormat:@"<%@:%p> %@", NSStringFromClass([self class]), self, [self statisticsDescription]];
+}
+
+@end
@@ -66,7 +66,7 @@
 // Do this before generating member names.
 - (void)generateTypedefName:(NSString *)baseName;
 {
-    NSString *digest = [self.type.typeString SHA1DigestString];
+    NSString *digest = [self.type.typeString FNV1aDigestString];
     NSUInteger length = [digest length];
     if (length > 8)
         digest = [digest substringFromIndex:length - 8];
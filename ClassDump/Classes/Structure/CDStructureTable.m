@@ -37,6 +37,7 @@
 //           - Then we group the CDStructureInfos, named structures by name, anon structures by reallyBareTypeString
 //             - If they could be combined, the combined CDStructureInfo is to phase2_namedStructureInfo or phase2_anonStructureInfo.
 //             - If they couldn't be combined, the uncombined CDStructureInfos are added to phase2_nameExceptions or phase2_anonExceptions.
+//             - Groups that don't share any types are combined in parallel, the results are recorded in the usual order afterwards.
 
 // Phase 3 - Using all of the information available from the merged types from phase 2, we merge these types with the types from phase 0
 //           to fill in missing member names, and the occasional object type.
@@ -288,30 +289,22 @@ static BOOL debugAnonStructures = NO;
 
     // Now... for each group, make sure we can combine them all together.
     // If not, this means that either the types or the member names conflicted, and we save the entire group as an exception.
-    for (NSString *key in [nameDict allKeys]) {
-        CDStructureInfo *combined = nil;
-
-        //CDLogVerbose(@"key... %@", key);
-        NSMutableArray *group = nameDict[key];
-        for (CDStructureInfo *info in group) {
-            if (combined == nil) {
-                combined = [info copy];
-            } else {
-                //CDLogVerbose(@"old: %@", [[combined type] typeString]);
-                //CDLogVerbose(@"new: %@", [[info type] typeString]);
-                if ([combined.type canMergeWithType:info.type]) {
-                    [combined.type mergeWithType:info.type];
-                    [combined addReferenceCount:info.referenceCount];
-#if 0
-                    if (info.isUsedInMethod)
-                        combined.isUsedInMethod = YES;
-#endif
-                } else {
-                    combined = nil;
-                    break;
-                }
-            }
-        }
+    NSArray *nameKeys = [nameDict allKeys];
+    NSArray *anonKeys = [anonDict allKeys];
+    NSMutableArray *groups = [NSMutableArray arrayWithCapacity:[nameKeys count] + [anonKeys count]];
+    for (NSString *key in nameKeys)
+        [groups addObject:nameDict[key]];
+    for (NSString *key in anonKeys)
+        [groups addObject:anonDict[key]];
+
+    NSArray *combinedInfos = [self phase2CombineGroups:groups anonymousFromIndex:[nameKeys count]];
+
+    // Record the results serially, in the same order as ever, so the output doesn't depend on how the merges were scheduled.
+    NSUInteger groupIndex = 0;
+    for (NSString *key in nameKeys) {
+        NSMutableArray *group = groups[groupIndex];
+        CDStructureInfo *combined = combinedInfos[groupIndex] == [NSNull null] ? nil : combinedInfos[groupIndex];
+        groupIndex++;
 
         if (combined != nil) {
             CDStructureInfo *previousInfo = _phase2_namedStructureInfo[key];
@@ -340,36 +333,10 @@ static BOOL debugAnonStructures = NO;
     }
 
     //CDLogVerbose(@"======================================================================");
-    for (NSString *key in [anonDict allKeys]) {
-        CDStructureInfo *combined = nil;
-
-        //CDLogVerbose(@"key... %@", key);
-        NSMutableArray *group = anonDict[key];
-        for (CDStructureInfo *info in group) {
-            if (combined == nil) {
-                combined = [info copy];
-                //CDLogVerbose(@"info: %@", [info shortDescription]);
-                //CDLogVerbose(@"combined: %@", [combined shortDescription]);
-            } else {
-                //CDLogVerbose(@"old: %@", [combined shortDescription]);
-                //CDLogVerbose(@"new: %@", [info shortDescription]);
-                if ([combined.type canMergeWithType:info.type]) {
-                    [combined.type mergeWithType:info.type];
-                    [combined addReferenceCount:info.referenceCount];
-#if 0
-                    if (info.isUsedInMethod)
-                        combined.isUsedInMethod = YES;
-#endif
-                } else {
-                    if (debugAnonStructures) {
-                        CDLogVerbose(@"previous: %@", combined.type.typeString);
-                        CDLogVerbose(@"    This: %@", info.type.typeString);
-                    }
-                    combined = nil;
-                    break;
-                }
-            }
-        }
+    for (NSString *key in anonKeys) {
+        NSMutableArray *group = groups[groupIndex];
+        CDStructureInfo *combined = combinedInfos[groupIndex] == [NSNull null] ? nil : combinedInfos[groupIndex];
+        groupIndex++;
 
         if (combined != nil) {
             if (_phase2_anonStructureInfo[key] != nil) {
@@ -390,6 +357,144 @@ static BOOL debugAnonStructures = NO;
     }
 }
 
+// Returns the combined CDStructureInfo for each group, or NSNull where the group couldn't be combined.
+//
+// Merging changes the types in place, and earlier merges can leave member types shared between structures.  Groups that
+// share any type with each other are combined serially, in order, by the same worker.  Everything else runs in parallel.
+- (NSArray *)phase2CombineGroups:(NSArray<NSArray<CDStructureInfo *> *> *)groups anonymousFromIndex:(NSUInteger)anonymousIndex;
+{
+    NSUInteger count = [groups count];
+    NSMutableArray *combinedInfos = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 0; index < count; index++)
+        [combinedInfos addObject:[NSNull null]];
+
+    NSArray<NSArray<NSNumber *> *> *batches;
+    if (self.typeController.configuration.shouldMergeStructuresInParallel && count > 1) {
+        batches = [self phase2IndependentBatchesOfGroups:groups];
+    } else {
+        NSMutableArray *indexes = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger index = 0; index < count; index++)
+            [indexes addObject:@(index)];
+        batches = @[ indexes ];
+    }
+
+    void (^combineBatch)(size_t) = ^(size_t batchIndex) {
+        for (NSNumber *groupIndex in batches[batchIndex]) {
+            NSUInteger index = [groupIndex unsignedIntegerValue];
+            CDStructureInfo *combined = [self phase2CombinedInfoForGroup:groups[index] isAnonymous:index >= anonymousIndex];
+            if (combined != nil) {
+                @synchronized (combinedInfos) {
+                    combinedInfos[index] = combined;
+                }
+            }
+        }
+    };
+
+    if ([batches count] > 1) {
+        dispatch_apply([batches count], dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), combineBatch);
+    } else if ([batches count] == 1) {
+        combineBatch(0);
+    }
+
+    return combinedInfos;
+}
+
+- (CDStructureInfo *)phase2CombinedInfoForGroup:(NSArray<CDStructureInfo *> *)group isAnonymous:(BOOL)isAnonymous;
+{
+    CDStructureInfo *combined = nil;
+
+    for (CDStructureInfo *info in group) {
+        if (combined == nil) {
+            combined = [info copy];
+            //CDLogVerbose(@"info: %@", [info shortDescription]);
+            //CDLogVerbose(@"combined: %@", [combined shortDescription]);
+        } else {
+            //CDLogVerbose(@"old: %@", [combined shortDescription]);
+            //CDLogVerbose(@"new: %@", [info shortDescription]);
+            if ([combined.type canMergeWithType:info.type]) {
+                [combined.type mergeWithType:info.type];
+                [combined addReferenceCount:info.referenceCount];
+#if 0
+                if (info.isUsedInMethod)
+                    combined.isUsedInMethod = YES;
+#endif
+            } else {
+                if (isAnonymous && debugAnonStructures) {
+                    CDLogVerbose(@"previous: %@", combined.type.typeString);
+                    CDLogVerbose(@"    This: %@", info.type.typeString);
+                }
+                return nil;
+            }
+        }
+    }
+
+    return combined;
+}
+
+// Partitions the group indexes into batches that don't share any type nodes.  Each batch is in ascending order, and
+// the batches are ordered by their first group.
+- (NSArray<NSArray<NSNumber *> *> *)phase2IndependentBatchesOfGroups:(NSArray<NSArray<CDStructureInfo *> *> *)groups;
+{
+    NSUInteger count = [groups count];
+    NSMutableData *parentData = [NSMutableData dataWithLength:count * sizeof(NSUInteger)];
+    NSUInteger *parents = [parentData mutableBytes];
+    for (NSUInteger index = 0; index < count; index++)
+        parents[index] = index;
+
+    NSUInteger (^findRoot)(NSUInteger) = ^NSUInteger(NSUInteger index) {
+        while (parents[index] != index) {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    };
+
+    // Group index + 1, keyed by node.  Merging only ever follows subtypes and members.
+    NSMapTable *ownerByNode = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                                        valueOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality
+                                                            capacity:0];
+    NSMutableArray<CDType *> *stack = [[NSMutableArray alloc] init];
+    [groups enumerateObjectsUsingBlock:^(NSArray<CDStructureInfo *> *group, NSUInteger groupIndex, BOOL *stop) {
+        for (CDStructureInfo *info in group) {
+            [stack addObject:info.type];
+            while ([stack count] > 0) {
+                CDType *type = [stack lastObject];
+                [stack removeLastObject];
+
+                NSUInteger owner = (NSUInteger)NSMapGet(ownerByNode, (__bridge const void *)type);
+                if (owner == groupIndex + 1)
+                    continue; // Already visited for this group
+
+                if (owner != 0) {
+                    NSUInteger root = findRoot(owner - 1), groupRoot = findRoot(groupIndex);
+                    if (root != groupRoot)
+                        parents[MAX(root, groupRoot)] = MIN(root, groupRoot);
+                }
+                NSMapInsert(ownerByNode, (__bridge const void *)type, (const void *)(groupIndex + 1));
+
+                if (type.subtype != nil)
+                    [stack addObject:type.subtype];
+                [stack addObjectsFromArray:type.members];
+            }
+        }
+    }];
+
+    NSMutableArray<NSMutableArray<NSNumber *> *> *batches = [[NSMutableArray alloc] init];
+    NSMutableDictionary<NSNumber *, NSMutableArray<NSNumber *> *> *batchesByRoot = [[NSMutableDictionary alloc] init];
+    for (NSUInteger index = 0; index < count; index++) {
+        NSNumber *root = @(findRoot(index));
+        NSMutableArray<NSNumber *> *batch = batchesByRoot[root];
+        if (batch == nil) {
+            batch = [[NSMutableArray alloc] init];
+            batchesByRoot[root] = batch;
+            [batches addObject:batch];
+        }
+        [batch addObject:@(index)];
+    }
+
+    return batches;
+}
+
 - (CDType *)phase2ReplacementForType:(CDType *)type;
 {
     NSString *name = [type.typeName description];
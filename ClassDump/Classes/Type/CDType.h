@@ -7,6 +7,8 @@
 
 @class CDTypeController, CDTypeFormatter, CDTypeName;
 
+// -isEqual: and -hash compare the type strings, which change when a type is merged or named.  Don't change a type
+// while it's in a set or is a dictionary key.
 @interface CDType : NSObject <NSCopying>
 
 @property (strong) NSString *variableName;
@@ -33,6 +35,7 @@
 @property (readonly) NSString *reallyBareTypeString;
 @property (readonly) NSString *keyTypeString;
 @property (readonly) NSArray *memberVariableNames;
+@property (readonly) uint64_t structuralHash;
 
 - (instancetype)initSimpleType:(int)type;
 - (instancetype)initIDType:(CDTypeName *)name;
@@ -47,6 +50,12 @@
 - (instancetype)initBlockTypeWithTypes:(NSArray *)types;
 - (instancetype)initModifier:(int)modifier type:(CDType *)type;
 
+// The type strings are memoized.  Call this after changing a type other than through the methods below, it also
+// invalidates every type containing this one.
+- (void)invalidateTypeStrings;
+// Called by CDTypeName when the name it's the typeName of changes.
+- (void)typeNameDidChange;
+
 - (BOOL)canMergeWithType:(CDType *)otherType;
 - (void)mergeWithType:(CDType *)otherType;
 - (void)generateMemberNames;
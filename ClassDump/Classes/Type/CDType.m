@@ -14,10 +14,36 @@
 #import <ClassDump/ClassDumpUtils.h>
 #import <ClassDump/CDClassDumpConfiguration.h>
 
+#include <os/lock.h>
+#include <stdatomic.h>
+
 static BOOL debugMerge = NO;
 
+typedef NS_ENUM(NSUInteger, CDTypeStringStyle) {
+    CDTypeStringStyle_Full,         // -typeString, variable names at every level
+    CDTypeStringStyle_Key,          // -keyTypeString, variable names at the top level
+    CDTypeStringStyle_Bare,         // -bareTypeString, no variable names
+    CDTypeStringStyle_ReallyBare,   // -reallyBareTypeString, no variable names or object types
+    CDTypeStringStyleCount,
+};
+
+// The memoized strings of one type, for one version of it.  Never changed once published, a new memo replaces it.
+@interface CDTypeStringMemo : NSObject
+{
+@public
+    uint64_t _version;
+    NSString *_strings[CDTypeStringStyleCount];
+    uint64_t _hash; // 0 until computed
+}
+@end
+
+@implementation CDTypeStringMemo
+@end
+
 @interface CDType ()
 //@property (nonatomic, readonly) NSString *formattedStringForSimpleType;
+// Atomic, so a memo is always read and replaced whole.  Only valid while its version is the type's current version.
+@property (atomic, strong) CDTypeStringMemo *typeStringMemo;
 @end
 
 #pragma mark -
@@ -78,14 +104,90 @@ static BOOL debugMerge = NO;
     NSString *_arraySize;
     
     NSString *_variableName;
+
+    // A type's strings include those of its members and subtype, so changing a type bumps its version and the versions
+    // of every type containing it.  Members can be shared after merging, so a type can have more than one parent.
+    _Atomic uint64_t _typeStringVersion;
+    os_unfair_lock _parentsLock;
+    __weak CDType *_parent;
+    NSHashTable<CDType *> *_additionalParents; // Weak, only created for shared types
+}
+
+#pragma mark - Memoized type strings
+
+- (void)addParent:(CDType *)parent;
+{
+    os_unfair_lock_lock(&_parentsLock);
+    CDType *existingParent = _parent;
+    if (existingParent == nil) {
+        _parent = parent;
+    } else if (existingParent != parent) {
+        if (_additionalParents == nil)
+            _additionalParents = [NSHashTable weakObjectsHashTable];
+        [_additionalParents addObject:parent];
+    }
+    os_unfair_lock_unlock(&_parentsLock);
+}
+
+- (void)adoptChildren;
+{
+    [_subtype addParent:self];
+    for (CDType *member in _members)
+        [member addParent:self];
+}
+
+- (void)invalidateTypeStrings;
+{
+    atomic_fetch_add_explicit(&_typeStringVersion, 1, memory_order_release);
+    [self invalidateParentTypeStrings];
+}
+
+- (void)invalidateParentTypeStrings;
+{
+    os_unfair_lock_lock(&_parentsLock);
+    CDType *parent = _parent;
+    NSArray<CDType *> *additionalParents = [_additionalParents allObjects];
+    os_unfair_lock_unlock(&_parentsLock);
+
+    [parent invalidateTypeStrings];
+    for (CDType *additionalParent in additionalParents)
+        [additionalParent invalidateTypeStrings];
+}
+
+// Returns the memo if it's current, otherwise nil.
+- (CDTypeStringMemo *)currentTypeStringMemoForVersion:(uint64_t)version;
+{
+    CDTypeStringMemo *memo = self.typeStringMemo;
+    return memo != nil && memo->_version == version ? memo : nil;
+}
+
+// Publishes a copy of the current memo with one more value filled in.  If the type changed while the value was being
+// computed, the memo is already out of date and is dropped.
+- (void)publishTypeStringMemoForVersion:(uint64_t)version update:(void (^)(CDTypeStringMemo *memo))update;
+{
+    CDTypeStringMemo *previousMemo = [self currentTypeStringMemoForVersion:version];
+    CDTypeStringMemo *memo = [[CDTypeStringMemo alloc] init];
+    memo->_version = version;
+    if (previousMemo != nil) {
+        for (NSUInteger index = 0; index < CDTypeStringStyleCount; index++)
+            memo->_strings[index] = previousMemo->_strings[index];
+        memo->_hash = previousMemo->_hash;
+    }
+    update(memo);
+
+    if (atomic_load_explicit(&_typeStringVersion, memory_order_acquire) == version)
+        self.typeStringMemo = memo;
 }
 
+#pragma mark -
+
 - (instancetype)initSimpleType:(int)type;
 {
     if ((self = [self init])) {
         if (type == '*') {
             _primitiveType = '^';
             _subtype = [[CDType alloc] initSimpleType:'c'];
+            [self adoptChildren];
         } else {
             _primitiveType = type;
         }
@@ -105,6 +207,7 @@ static BOOL debugMerge = NO;
         if (name != nil) {
             _primitiveType = T_NAMED_OBJECT;
             _typeName = name;
+            _typeName.owningType = self;
         } else {
             _primitiveType = '@';
         }
@@ -129,7 +232,9 @@ static BOOL debugMerge = NO;
     if ((self = [self init])) {
         _primitiveType = '{';
         _typeName = name;
+        _typeName.owningType = self;
         _members = [[NSMutableArray alloc] initWithArray:members];
+        [self adoptChildren];
     }
 
     return self;
@@ -140,7 +245,9 @@ static BOOL debugMerge = NO;
     if ((self = [self init])) {
         _primitiveType = '(';
         _typeName = name;
+        _typeName.owningType = self;
         _members = [[NSMutableArray alloc] initWithArray:members];
+        [self adoptChildren];
     }
 
     return self;
@@ -162,6 +269,7 @@ static BOOL debugMerge = NO;
         _primitiveType = '[';
         _arraySize = count;
         _subtype = type;
+        [self adoptChildren];
     }
 
     return self;
@@ -172,6 +280,7 @@ static BOOL debugMerge = NO;
     if ((self = [self init])) {
         _primitiveType = '^';
         _subtype = type;
+        [self adoptChildren];
     }
 
     return self;
@@ -201,6 +310,7 @@ static BOOL debugMerge = NO;
     if ((self = [self init])) {
         _primitiveType = modifier;
         _subtype = type;
+        [self adoptChildren];
     }
 
     return self;
@@ -230,17 +340,46 @@ static BOOL debugMerge = NO;
 
 #pragma mark -
 
+- (NSString *)variableName;
+{
+    return _variableName;
+}
+
+// The variable name only shows up in the type strings of the types containing this one.
+- (void)setVariableName:(NSString *)variableName;
+{
+    BOOL didChange = _variableName != variableName && [_variableName isEqualToString:variableName] == NO;
+    _variableName = variableName;
+    if (didChange)
+        [self invalidateParentTypeStrings];
+}
+
+// Renaming the type name changes this type's strings.  Called by CDTypeName.
+- (void)typeNameDidChange;
+{
+    [self invalidateTypeStrings];
+}
+
+#pragma mark -
+
 // TODO: (2009-08-26) Looks like this doesn't compare the variable name.
 - (BOOL)isEqual:(id)object;
 {
     if ([object isKindOfClass:[self class]]) {
         CDType *otherType = object;
+        if (self.structuralHash != otherType.structuralHash)
+            return NO;
         return [self.typeString isEqual:otherType.typeString];
     }
     
     return NO;
 }
 
+- (NSUInteger)hash;
+{
+    return (NSUInteger)self.structuralHash;
+}
+
 #pragma mark - Debugging
 
 - (NSString *)description;
@@ -301,28 +440,66 @@ static BOOL debugMerge = NO;
 
 - (NSString *)typeString;
 {
-    return [self _typeStringWithVariableNamesToLevel:1e6 showObjectTypes:YES];
+    return [self typeStringWithStyle:CDTypeStringStyle_Full];
 }
 
 - (NSString *)bareTypeString;
 {
-    return [self _typeStringWithVariableNamesToLevel:0 showObjectTypes:YES];
+    return [self typeStringWithStyle:CDTypeStringStyle_Bare];
 }
 
 - (NSString *)reallyBareTypeString;
 {
-    return [self _typeStringWithVariableNamesToLevel:0 showObjectTypes:NO];
+    return [self typeStringWithStyle:CDTypeStringStyle_ReallyBare];
 }
 
 - (NSString *)keyTypeString;
 {
     // use variable names at top level
-    return [self _typeStringWithVariableNamesToLevel:1 showObjectTypes:YES];
+    return [self typeStringWithStyle:CDTypeStringStyle_Key];
+}
+
+// FNV-1a of the typeString, so equal types have equal hashes.
+- (uint64_t)structuralHash;
+{
+    uint64_t version = atomic_load_explicit(&_typeStringVersion, memory_order_acquire);
+    CDTypeStringMemo *memo = [self currentTypeStringMemoForVersion:version];
+    if (memo != nil && memo->_hash != 0)
+        return memo->_hash;
+
+    uint64_t hash = self.typeString.FNV1aHash;
+    if (hash == 0)
+        hash = 1; // 0 means not computed
+
+    [self publishTypeStringMemoForVersion:version update:^(CDTypeStringMemo *newMemo) {
+        newMemo->_hash = hash;
+    }];
+
+    return hash;
+}
+
+- (NSString *)typeStringWithStyle:(CDTypeStringStyle)style;
+{
+    uint64_t version = atomic_load_explicit(&_typeStringVersion, memory_order_acquire);
+    CDTypeStringMemo *memo = [self currentTypeStringMemoForVersion:version];
+    if (memo != nil && memo->_strings[style] != nil)
+        return memo->_strings[style];
+
+    NSString *result = [self _typeStringWithStyle:style];
+
+    [self publishTypeStringMemoForVersion:version update:^(CDTypeStringMemo *newMemo) {
+        newMemo->_strings[style] = result;
+    }];
+
+    return result;
 }
 
-- (NSString *)_typeStringWithVariableNamesToLevel:(NSUInteger)level showObjectTypes:(BOOL)shouldShowObjectTypes;
+// The members and subtype are built from their own memoized strings.  Variable names only ever appear at the top
+// level of a key type string, so its members use the bare style, and its subtype still uses the key style.
+- (NSString *)_typeStringWithStyle:(CDTypeStringStyle)style;
 {
     NSString *result;
+    BOOL shouldShowObjectTypes = style != CDTypeStringStyle_ReallyBare;
     
     switch (_primitiveType) {
         case T_NAMED_OBJECT:
@@ -342,29 +519,29 @@ static BOOL debugMerge = NO;
             break;
             
         case '[':
-            result = [NSString stringWithFormat:@"[%@%@]", _arraySize, [_subtype _typeStringWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+            result = [NSString stringWithFormat:@"[%@%@]", _arraySize, [_subtype typeStringWithStyle:style]];
             break;
             
         case '(':
             if (_typeName == nil) {
-                return [NSString stringWithFormat:@"(%@)", [self _typeStringForMembersWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+                return [NSString stringWithFormat:@"(%@)", [self _typeStringForMembersWithStyle:style]];
             } else if ([_members count] == 0) {
                 return [NSString stringWithFormat:@"(%@)", _typeName];
             } else {
-                return [NSString stringWithFormat:@"(%@=%@)", _typeName, [self _typeStringForMembersWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+                return [NSString stringWithFormat:@"(%@=%@)", _typeName, [self _typeStringForMembersWithStyle:style]];
             }
             
         case '{':
             if (_typeName == nil) {
-                return [NSString stringWithFormat:@"{%@}", [self _typeStringForMembersWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+                return [NSString stringWithFormat:@"{%@}", [self _typeStringForMembersWithStyle:style]];
             } else if ([_members count] == 0) {
                 return [NSString stringWithFormat:@"{%@}", _typeName];
             } else {
-                return [NSString stringWithFormat:@"{%@=%@}", _typeName, [self _typeStringForMembersWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+                return [NSString stringWithFormat:@"{%@=%@}", _typeName, [self _typeStringForMembersWithStyle:style]];
             }
             
         case '^':
-            result = [NSString stringWithFormat:@"^%@", [_subtype _typeStringWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+            result = [NSString stringWithFormat:@"^%@", [_subtype typeStringWithStyle:style]];
             break;
             
         case 'j':
@@ -376,7 +553,7 @@ static BOOL debugMerge = NO;
         case 'R':
         case 'V':
         case 'A':
-            result = [NSString stringWithFormat:@"%c%@", _primitiveType, [_subtype _typeStringWithVariableNamesToLevel:level showObjectTypes:shouldShowObjectTypes]];
+            result = [NSString stringWithFormat:@"%c%@", _primitiveType, [_subtype typeStringWithStyle:style]];
             break;
             
         case T_FUNCTION_POINTER_TYPE:
@@ -395,15 +572,17 @@ static BOOL debugMerge = NO;
     return result;
 }
 
-- (NSString *)_typeStringForMembersWithVariableNamesToLevel:(NSInteger)level showObjectTypes:(BOOL)shouldShowObjectTypes;
+- (NSString *)_typeStringForMembersWithStyle:(CDTypeStringStyle)style;
 {
     NSParameterAssert(_primitiveType == '{' || _primitiveType == '(');
     NSMutableString *str = [NSMutableString string];
 
+    BOOL shouldShowVariableNames = style == CDTypeStringStyle_Full || style == CDTypeStringStyle_Key;
+    CDTypeStringStyle memberStyle = style == CDTypeStringStyle_Key ? CDTypeStringStyle_Bare : style;
     for (CDType *member in _members) {
-        if (member.variableName != nil && level > 0)
+        if (member.variableName != nil && shouldShowVariableNames)
             [str appendFormat:@"\"%@\"", member.variableName];
-        [str appendString:[member _typeStringWithVariableNamesToLevel:level - 1 showObjectTypes:shouldShowObjectTypes]];
+        [str appendString:[member typeStringWithStyle:memberStyle]];
     }
 
     return str;
@@ -515,6 +694,8 @@ static BOOL debugMerge = NO;
         //CDLog(@"otherType: %@", [otherType typeString]);
         _primitiveType = T_NAMED_OBJECT;
         _typeName = [otherType.typeName copy];
+        _typeName.owningType = self;
+        [self invalidateTypeStrings];
         return;
     }
 
@@ -541,6 +722,8 @@ static BOOL debugMerge = NO;
         NSParameterAssert(_members != nil);
         [_members removeAllObjects];
         [_members addObjectsFromArray:otherMembers];
+        [self adoptChildren];
+        [self invalidateTypeStrings];
         //[self setMembers:otherMembers];
     } else if (count != otherCount) {
         // Not so bad after all.  Even kind of common.  Consider _flags.
@@ -571,7 +754,7 @@ static BOOL debugMerge = NO;
 
         if (otherVariableName != nil) {
             if (thisVariableName == nil)
-                thisMember.variableName = otherVariableName;
+                thisMember.variableName = otherVariableName; // Invalidates the type strings
             else if ([thisVariableName isEqual:otherVariableName] == NO)
                 CDLog(@"Warning: Different variable names for same member...");
         }
@@ -606,7 +789,7 @@ static BOOL debugMerge = NO;
                 do {
                     name = [NSString stringWithFormat:@"_field%lu", number++];
                 } while ([usedNames containsObject:name]);
-                member.variableName = name;
+                member.variableName = name; // Invalidates the type strings
             }
         }
     }
@@ -620,7 +803,7 @@ static BOOL debugMerge = NO;
 
     if ([_typeName.name hasPrefix:@"$"]) {
 //        if (flag) CDLog(@"%s, changing type name %@ to ?", __PRETTY_FUNCTION__, type.typeName.name);
-        _typeName.name = @"?";
+        _typeName.name = @"?"; // Invalidates the cached type strings
     }
 
     for (CDType *member in _members) {
@@ -31,6 +31,8 @@
     
     CDStructureTable *_structureTable;
     CDStructureTable *_unionTable;
+    
+    NSUInteger _replacementGeneration;
 }
 
 - (instancetype)initWithConfiguration:(CDClassDumpConfiguration *)configuration
@@ -126,6 +128,11 @@
     return nil;
 }
 
+- (NSUInteger)replacementGenerationForTypeFormatter:(CDTypeFormatter *)typeFormatter;
+{
+    return _replacementGeneration;
+}
+
 - (void)typeFormatter:(CDTypeFormatter *)typeFormatter didReferenceClassName:(NSString *)name;
 {
     if ([self.delegate respondsToSelector:@selector(typeController:didReferenceClassName:)])
@@ -170,12 +177,14 @@
 {
     [self.structureTable generateTypedefNames];
     [self.unionTable     generateTypedefNames];
+    _replacementGeneration++;
 }
 
 - (void)generateMemberNames;
 {
     [self.structureTable generateMemberNames];
     [self.unionTable     generateMemberNames];
+    _replacementGeneration++;
 }
 
 #pragma mark - Run phase 1+
@@ -222,6 +231,7 @@
         [self.structureTable finishPhase0];
         [self.unionTable     finishPhase0];
     }
+    _replacementGeneration++;
 }
 
 #pragma mark - Phase 1
@@ -237,6 +247,7 @@
     
     [self.structureTable finishPhase1];
     [self.unionTable     finishPhase1];
+    _replacementGeneration++;
     //CDLog(@"<  %s", __PRETTY_FUNCTION__);
 }
 
@@ -269,6 +280,7 @@
     //[self.structureTable logPhase2Info];
     [self.structureTable finishPhase2];
     [self.unionTable     finishPhase2];
+    _replacementGeneration++;
 }
 
 - (void)startPhase3;
@@ -296,6 +308,7 @@
     
     [self.structureTable finishPhase3];
     [self.unionTable     finishPhase3];
+    _replacementGeneration++;
     //[structureTable logPhase3Info];
     
     // - All named structures (minus exceptions like struct _flags) get declared at the top level
@@ -16,6 +16,8 @@
 - (BOOL)shouldExpandType:(CDType *)type;
 //// TODO: (2009-08-26) Ideally, just formatting a type shouldn't change it.  These changes should be done before, but this is handy.
 - (void)phase3MergeWithType:(CDType *)type;
+// Changes whenever formatting the same type could come out differently, because structures were registered, merged or named.
+- (NSUInteger)replacementGenerationForTypeFormatter:(CDTypeFormatter *)typeFormatter;
 @end
 
 
@@ -34,6 +36,10 @@
 
 - (NSString *)formatVariable:(NSString *)name type:(CDType *)type;
 - (NSString *)formatMethodName:(NSString *)name typeString:(NSString *)typeString;
+// Cached by name and typeString.  methodTypes are the already parsed typeString, or nil to parse it here if it's needed.
+- (NSString *)formatMethodName:(NSString *)name typeString:(NSString *)typeString methodTypes:(NSArray *)methodTypes;
+// Uncached, for types that have already been parsed.
+- (NSString *)formatMethodName:(NSString *)name methodTypes:(NSArray *)methodTypes;
 - (NSString *)typedefNameForStructure:(CDType *)structureType level:(NSUInteger)level;
 - (NSString *)formattedString:(NSString *)previousName type:(CDType *)type level:(NSUInteger)level;
 - (void)formattingDidReferenceClassName:(NSString *)name;
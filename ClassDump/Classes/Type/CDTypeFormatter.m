@@ -8,7 +8,7 @@
 #import <ClassDump/CDMethodType.h>
 #import <ClassDump/CDType.h>
 #import <ClassDump/CDTypeLexer.h>
-#import <ClassDump/CDTypeParser.h>
+#import <ClassDump/CDTypeParseCache.h>
 #import <ClassDump/CDTypeController.h>
 #import <ClassDump/NSString-CDExtensions.h>
 #import <ClassDump/NSScanner-CDExtensions.h>
@@ -17,12 +17,29 @@
 #import <ClassDump/CDTypeName.h>
 
 
+// A formatted method, along with the class and protocol names that formatting it reported to the delegate, in order.
+// These are replayed on a cache hit, so the delegate sees the same references either way.
+@interface CDTypeFormatterMethodResult : NSObject
+@property (strong) NSString *formattedString;
+@property (strong) NSArray *references; // NSString for a class name, NSArray for protocol names
+@end
+
+@implementation CDTypeFormatterMethodResult
+@end
+
+#pragma mark -
+
 @interface CDTypeFormatter ()
 @end
 
 #pragma mark -
 
 @implementation CDTypeFormatter
+{
+    NSMutableDictionary<NSString *, CDTypeFormatterMethodResult *> *_formattedMethods;
+    NSUInteger _formattedMethodsGeneration;
+    NSMutableArray *_recordedReferences;
+}
 
 - (instancetype)initWithConfiguration:(CDClassDumpConfiguration *)configuration
 {
@@ -31,6 +48,7 @@
         _shouldExpand = NO;
         _shouldAutoExpand = NO;
         _configuration = configuration;
+        _formattedMethods = [[NSMutableDictionary alloc] init];
     }
 
     return self;
@@ -99,13 +117,16 @@
 
 - (NSDictionary *)formattedTypesForMethodName:(NSString *)name type:(NSString *)type;
 {
-    CDTypeParser *parser = [[CDTypeParser alloc] initWithString:type];
-
     NSError *error = nil;
-    NSArray *methodTypes = [parser parseMethodType:&error];
+    NSArray *methodTypes = [[CDTypeParseCache sharedCache] methodTypesForEncoding:type error:&error];
     if (methodTypes == nil)
         CDLog(@"Warning: Parsing method types failed, %@", name);
 
+    return [self formattedTypesForMethodName:name methodTypes:methodTypes];
+}
+
+- (NSDictionary *)formattedTypesForMethodName:(NSString *)name methodTypes:(NSArray *)methodTypes;
+{
     if (methodTypes == nil || [methodTypes count] == 0) {
         return nil;
     }
@@ -179,13 +200,64 @@
 
 - (NSString *)formatMethodName:(NSString *)methodName typeString:(NSString *)typeString;
 {
-    CDTypeParser *parser = [[CDTypeParser alloc] initWithString:typeString];
+    return [self formatMethodName:methodName typeString:typeString methodTypes:nil];
+}
+
+// The same selector and encoding turn up in class after class, and in every header that declares them.  Format each
+// pair once per generation of the delegate's structure tables.  A new generation can change typedef names and
+// which structures get expanded, so it empties the cache.
+- (NSString *)formatMethodName:(NSString *)methodName typeString:(NSString *)typeString methodTypes:(NSArray *)methodTypes;
+{
+    if (typeString == nil)
+        return [self formatMethodName:methodName methodTypes:methodTypes];
 
-    NSError *error = nil;
-    NSArray *methodTypes = [parser parseMethodType:&error];
-    if (methodTypes == nil)
-        CDLog(@"Warning: Parsing method types failed, %@", methodName);
+    NSString *key = [NSString stringWithFormat:@"%@\n%@", methodName, typeString];
+    NSUInteger generation = [self.delegate replacementGenerationForTypeFormatter:self];
 
+    CDTypeFormatterMethodResult *result;
+    @synchronized (_formattedMethods) {
+        if (generation != _formattedMethodsGeneration) {
+            [_formattedMethods removeAllObjects];
+            _formattedMethodsGeneration = generation;
+        }
+        result = _formattedMethods[key];
+    }
+
+    if (result != nil) {
+        for (id reference in result.references) {
+            if ([reference isKindOfClass:[NSString class]])
+                [self.delegate typeFormatter:self didReferenceClassName:reference];
+            else
+                [self.delegate typeFormatter:self didReferenceProtocolNames:reference];
+        }
+
+        return result.formattedString;
+    }
+
+    if (methodTypes == nil) {
+        NSError *error = nil;
+        methodTypes = [[CDTypeParseCache sharedCache] methodTypesForEncoding:typeString error:&error];
+        if (methodTypes == nil)
+            CDLog(@"Warning: Parsing method types failed, %@", methodName);
+    }
+
+    NSMutableArray *previousReferences = _recordedReferences;
+    _recordedReferences = [[NSMutableArray alloc] init];
+    result = [[CDTypeFormatterMethodResult alloc] init];
+    result.formattedString = [self formatMethodName:methodName methodTypes:methodTypes];
+    result.references = [_recordedReferences copy];
+    _recordedReferences = previousReferences;
+
+    @synchronized (_formattedMethods) {
+        if (generation == _formattedMethodsGeneration)
+            _formattedMethods[key] = result;
+    }
+
+    return result.formattedString;
+}
+
+- (NSString *)formatMethodName:(NSString *)methodName methodTypes:(NSArray *)methodTypes;
+{
     if (methodTypes == nil || [methodTypes count] == 0) {
         return nil;
     }
@@ -270,11 +342,14 @@
 
 - (void)formattingDidReferenceClassName:(NSString *)name;
 {
+    if (name != nil)
+        [_recordedReferences addObject:name];
     [self.delegate typeFormatter:self didReferenceClassName:name];
 }
 
 - (void)formattingDidReferenceProtocolNames:(NSArray *)names;
 {
+    [_recordedReferences addObject:[names copy]];
     [self.delegate typeFormatter:self didReferenceProtocolNames:names];
 }
 
@@ -531,7 +606,7 @@
     blockSignatureTypeFormatter.baseLevel = 0;
     [targetType.types enumerateObjectsUsingBlock:^(CDType *type, NSUInteger idx, BOOL *stop) {
         if (idx != 1)
-            [blockSignatureString appendString:[blockSignatureTypeFormatter formatVariable:nil type:type]];
+            [blockSignatureString appendString:[blockSignatureTypeFormatter formatVariable:nil type:[type copy]]]; // Shared through CDTypeParseCache
         else
             [blockSignatureString appendString:@"(^)"];
         
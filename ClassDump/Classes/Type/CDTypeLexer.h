@@ -20,19 +20,22 @@ typedef enum : NSUInteger {
     CDTypeLexerState_TemplateTypes = 2,
 } CDTypeLexerState;
 
+// Works directly on the UTF-8 bytes of the type string, classifying ASCII with a lookup table.  Tokens are kept as
+// byte ranges, and only turned into strings when lexText is asked for.  Produces the same tokens the NSScanner based
+// lexer did, including for non-ASCII characters.
 @interface CDTypeLexer : NSObject
 
 - (instancetype)initWithString:(NSString *)string;
 
-@property (readonly) NSScanner *scanner;
 @property (nonatomic, assign) CDTypeLexerState state;
 @property (assign) BOOL shouldShowLexing;
 
 @property (nonatomic, readonly) NSString *string;
 - (int)scanNextToken;
 
-@property (strong) NSString *lexText;
+@property (nonatomic, strong) NSString *lexText;
 
+@property (nonatomic, readonly) NSUInteger scanLocation; // In UTF-16 units, like NSScanner
 @property (nonatomic, readonly) unichar peekChar;
 @property (nonatomic, readonly) NSString *remainingString;
 @property (nonatomic, readonly) NSString *peekIdentifier;
@@ -5,7 +5,6 @@
 
 #import <ClassDump/CDTypeLexer.h>
 
-#import <ClassDump/NSScanner-CDExtensions.h>
 #import <ClassDump/ClassDumpUtils.h>
 #ifdef DEBUG
 static BOOL debug = NO;
@@ -22,12 +21,71 @@ static NSString *CDTypeLexerStateName(CDTypeLexerState state)
     }
 }
 
+// These match the NSCharacterSets the NSScanner based lexer used.  The table covers ASCII, anything else is looked
+// up in the character sets themselves.
+enum {
+    CDTypeLexerCharacterClass_Digit        = 1 << 0, // decimalDigitCharacterSet
+    CDTypeLexerCharacterClass_Letter       = 1 << 1, // letterCharacterSet
+    CDTypeLexerCharacterClass_Alphanumeric = 1 << 2, // alphanumericCharacterSet
+    CDTypeLexerCharacterClass_Other        = 1 << 3, // $_:*, allowed anywhere in an identifier
+    CDTypeLexerCharacterClass_Whitespace   = 1 << 4, // whitespaceCharacterSet
+};
+
+#define CDTypeLexerIdentifierStart (CDTypeLexerCharacterClass_Letter | CDTypeLexerCharacterClass_Other)
+#define CDTypeLexerIdentifier      (CDTypeLexerCharacterClass_Alphanumeric | CDTypeLexerCharacterClass_Other)
+
+static const uint8_t CDTypeLexerCharacterClasses[128] = {
+    ['0' ... '9'] = CDTypeLexerCharacterClass_Digit | CDTypeLexerCharacterClass_Alphanumeric,
+    ['A' ... 'Z'] = CDTypeLexerCharacterClass_Letter | CDTypeLexerCharacterClass_Alphanumeric,
+    ['a' ... 'z'] = CDTypeLexerCharacterClass_Letter | CDTypeLexerCharacterClass_Alphanumeric,
+    ['$']         = CDTypeLexerCharacterClass_Other,
+    ['_']         = CDTypeLexerCharacterClass_Other,
+    [':']         = CDTypeLexerCharacterClass_Other,
+    ['*']         = CDTypeLexerCharacterClass_Other,
+    [' ']         = CDTypeLexerCharacterClass_Whitespace,
+    ['\t']        = CDTypeLexerCharacterClass_Whitespace,
+};
+
+// NSScanner worked on UTF-16, so characters outside the BMP were two surrogates that none of the sets matched.
+static BOOL CDTypeLexerCharacterIsInClasses(uint32_t ch, uint8_t classes)
+{
+    static NSCharacterSet *digitSet, *letterSet, *alphanumericSet, *whitespaceSet;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        digitSet        = [NSCharacterSet decimalDigitCharacterSet];
+        letterSet       = [NSCharacterSet letterCharacterSet];
+        alphanumericSet = [NSCharacterSet alphanumericCharacterSet];
+        whitespaceSet   = [NSCharacterSet whitespaceCharacterSet];
+    });
+
+    if (ch < 0x80)
+        return (CDTypeLexerCharacterClasses[ch] & classes) != 0;
+    if (ch > 0xFFFF)
+        return NO;
+
+    return ((classes & CDTypeLexerCharacterClass_Digit)        && [digitSet characterIsMember:(unichar)ch])
+        || ((classes & CDTypeLexerCharacterClass_Letter)       && [letterSet characterIsMember:(unichar)ch])
+        || ((classes & CDTypeLexerCharacterClass_Alphanumeric) && [alphanumericSet characterIsMember:(unichar)ch])
+        || ((classes & CDTypeLexerCharacterClass_Whitespace)   && [whitespaceSet characterIsMember:(unichar)ch]);
+}
+
 @implementation CDTypeLexer
 {
-    NSScanner *_scanner;
+    NSString *_string;
+    NSData *_utf8Data; // Only when the string doesn't expose its bytes directly
+    const uint8_t *_bytes;
+    NSUInteger _length;
+    NSUInteger _offset;
+    unichar _pendingLowSurrogate; // Second half of a character outside the BMP that was returned as a token
+
+    // Mirrors the NSScanner charactersToBeSkipped, which stayed set to whitespace after lexing template types.
+    BOOL _skipsWhitespace;
+
     CDTypeLexerState _state;
     NSString *_lexText;
-    
+    NSRange _lexRange;
+    BOOL _hasLexRange;
+
     BOOL _shouldShowLexing;
 }
 
@@ -35,11 +93,19 @@ static NSString *CDTypeLexerStateName(CDTypeLexerState state)
 {
     if ((self = [super init])) {
         if (!string){
-            CDLogVerbose(@"%s NSScanner initWithString: %@", __PRETTY_FUNCTION__, string);
+            CDLogVerbose(@"%s initWithString: %@", __PRETTY_FUNCTION__, string);
             return nil;
         }
-        _scanner = [[NSScanner alloc] initWithString:string];
-        [_scanner setCharactersToBeSkipped:nil];
+        _string = string;
+        const char *cString = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingASCII);
+        if (cString != NULL) {
+            _bytes  = (const uint8_t *)cString;
+            _length = [string length];
+        } else {
+            _utf8Data = [string dataUsingEncoding:NSUTF8StringEncoding];
+            _bytes    = [_utf8Data bytes];
+            _length   = [_utf8Data length];
+        }
         _state = CDTypeLexerState_Normal;
         _shouldShowLexing = debug;
     }
@@ -59,82 +125,183 @@ static NSString *CDTypeLexerStateName(CDTypeLexerState state)
 
 - (NSString *)string;
 {
-    return [_scanner string];
+    return _string;
 }
 
-- (int)scanNextToken;
+- (NSString *)lexText;
+{
+    if (_lexText == nil && _hasLexRange)
+        _lexText = [[NSString alloc] initWithBytes:_bytes + _lexRange.location length:_lexRange.length encoding:NSUTF8StringEncoding];
+
+    return _lexText;
+}
+
+- (void)setLexText:(NSString *)lexText;
+{
+    _lexText = lexText;
+    _hasLexRange = NO;
+}
+
+#pragma mark - Bytes
+
+// Decodes the character at offset, returning its length in bytes.  The bytes came from an NSString, so they're valid UTF-8.
+- (uint32_t)characterAtOffset:(NSUInteger)offset length:(NSUInteger *)length;
+{
+    uint8_t lead = _bytes[offset];
+    if (lead < 0x80) {
+        *length = 1;
+        return lead;
+    }
+
+    NSUInteger count = lead >= 0xF0 ? 4 : (lead >= 0xE0 ? 3 : 2);
+    if (offset + count > _length)
+        count = _length - offset;
+    uint32_t ch = lead & (0x7F >> count);
+    for (NSUInteger index = 1; index < count; index++)
+        ch = (ch << 6) | (_bytes[offset + index] & 0x3F);
+
+    *length = count;
+    return ch;
+}
+
+- (BOOL)characterAtOffset:(NSUInteger)offset isInClasses:(uint8_t)classes length:(NSUInteger *)length;
+{
+    if (offset >= _length)
+        return NO;
+
+    uint8_t byte = _bytes[offset];
+    if (byte < 0x80) {
+        *length = 1;
+        return (CDTypeLexerCharacterClasses[byte] & classes) != 0;
+    }
+
+    return CDTypeLexerCharacterIsInClasses([self characterAtOffset:offset length:length], classes);
+}
+
+// Returns the end of the run of characters in the classes starting at offset.
+- (NSUInteger)endOfRunAtOffset:(NSUInteger)offset inClasses:(uint8_t)classes;
+{
+    NSUInteger length;
+    while ([self characterAtOffset:offset isInClasses:classes length:&length])
+        offset += length;
+
+    return offset;
+}
+
+- (NSUInteger)endOfTemplateTypeAtOffset:(NSUInteger)offset;
+{
+    // Everything but '<', ',' and '>', including every non-ASCII byte.
+    while (offset < _length) {
+        uint8_t byte = _bytes[offset];
+        if (byte == '<' || byte == ',' || byte == '>')
+            break;
+        offset++;
+    }
+
+    return offset;
+}
+
+- (BOOL)isAtEnd;
 {
-    NSString *str;
-    unichar ch;
+    if (_pendingLowSurrogate != 0)
+        return NO;
 
+    NSUInteger offset = _skipsWhitespace ? [self endOfRunAtOffset:_offset inClasses:CDTypeLexerCharacterClass_Whitespace] : _offset;
+    return offset >= _length;
+}
+
+- (void)setLexRangeFrom:(NSUInteger)start to:(NSUInteger)end;
+{
+    _lexText = nil;
+    _lexRange = NSMakeRange(start, end - start);
+    _hasLexRange = YES;
+}
+
+#pragma mark -
+
+- (int)scanNextToken;
+{
     _lexText = nil;
+    _hasLexRange = NO;
 
-    if ([_scanner isAtEnd]) {
+    if ([self isAtEnd]) {
         if (_shouldShowLexing)                       CDLog(@"%s [state=%lu], token = TK_EOS", __PRETTY_FUNCTION__, _state);
         return TK_EOS;
     }
 
+    if (_pendingLowSurrogate != 0) {
+        unichar ch = _pendingLowSurrogate;
+        _pendingLowSurrogate = 0;
+        if (_shouldShowLexing)                       CDLog(@"%s [state=%lu], token = %d", __PRETTY_FUNCTION__, _state, ch);
+        return ch;
+    }
+
     if (_state == CDTypeLexerState_TemplateTypes) {
         // Skip whitespace, scan '<', ',', '>'.  Everything else is lumped together as a string.
-        [_scanner setCharactersToBeSkipped:[NSCharacterSet whitespaceCharacterSet]];
-        if ([_scanner scanString:@"<" intoString:NULL]) {
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = %d '%c'", __PRETTY_FUNCTION__, _state, '<', '<');
-            return '<';
-        }
-
-        if ([_scanner scanString:@">" intoString:NULL]) {
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = %d '%c'", __PRETTY_FUNCTION__, _state, '>', '>');
-            return '>';
+        _skipsWhitespace = YES;
+        _offset = [self endOfRunAtOffset:_offset inClasses:CDTypeLexerCharacterClass_Whitespace];
+        if (_offset < _length) {
+            uint8_t byte = _bytes[_offset];
+            if (byte == '<' || byte == '>' || byte == ',') {
+                _offset++;
+                if (_shouldShowLexing)               CDLog(@"%s [state=%lu], token = %d '%c'", __PRETTY_FUNCTION__, _state, byte, byte);
+                return byte;
+            }
         }
 
-        if ([_scanner scanString:@"," intoString:NULL]) {
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = %d '%c'", __PRETTY_FUNCTION__, _state, ',', ',');
-            return ',';
-        }
-
-        if ([_scanner my_scanCharactersFromSet:[NSScanner cdTemplateTypeCharacterSet] intoString:&str]) {
-            _lexText = str;
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_TEMPLATE_TYPE (%@)", __PRETTY_FUNCTION__, _state, _lexText);
+        NSUInteger end = [self endOfTemplateTypeAtOffset:_offset];
+        if (end > _offset) {
+            [self setLexRangeFrom:_offset to:end];
+            _offset = end;
+            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_TEMPLATE_TYPE (%@)", __PRETTY_FUNCTION__, _state, self.lexText);
             return TK_TEMPLATE_TYPE;
         }
 
         CDLog(@"Ooops, fell through in template types state.");
     } else if (_state == CDTypeLexerState_Identifier) {
-        NSString *identifier;
-
         //CDLog(@"Scanning in identifier state.");
-        [_scanner setCharactersToBeSkipped:nil];
+        _skipsWhitespace = NO;
 
-        if ([_scanner scanIdentifierIntoString:&identifier]) {
-            _lexText = identifier;
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_IDENTIFIER (%@)", __PRETTY_FUNCTION__, _state, _lexText);
+        NSUInteger end = [self endOfIdentifierAtOffset:_offset];
+        if (end > _offset) {
+            [self setLexRangeFrom:_offset to:end];
+            _offset = end;
+            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_IDENTIFIER (%@)", __PRETTY_FUNCTION__, _state, self.lexText);
             _state = CDTypeLexerState_Normal;
             return TK_IDENTIFIER;
         }
     } else {
-        [_scanner setCharactersToBeSkipped:nil];
-
-        if ([_scanner scanString:@"\"" intoString:NULL]) {
-            if ([_scanner scanUpToString:@"\"" intoString:&str])
-                _lexText = str;
-            else
-                _lexText = @"";
-
-            [_scanner scanString:@"\"" intoString:NULL];
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_QUOTED_STRING (%@)", __PRETTY_FUNCTION__, _state, _lexText);
+        _skipsWhitespace = NO;
+
+        if (_bytes[_offset] == '"') {
+            NSUInteger start = _offset + 1;
+            const uint8_t *quote = memchr(_bytes + start, '"', _length - start);
+            NSUInteger end = quote != NULL ? (NSUInteger)(quote - _bytes) : _length;
+            [self setLexRangeFrom:start to:end];
+            _offset = quote != NULL ? end + 1 : end;
+            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_QUOTED_STRING (%@)", __PRETTY_FUNCTION__, _state, self.lexText);
             return TK_QUOTED_STRING;
         }
 
-        if ([_scanner my_scanCharactersFromSet:[NSCharacterSet decimalDigitCharacterSet] intoString:&str]) {
-            _lexText = str;
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_NUMBER (%@)", __PRETTY_FUNCTION__, _state, _lexText);
+        NSUInteger end = [self endOfRunAtOffset:_offset inClasses:CDTypeLexerCharacterClass_Digit];
+        if (end > _offset) {
+            [self setLexRangeFrom:_offset to:end];
+            _offset = end;
+            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = TK_NUMBER (%@)", __PRETTY_FUNCTION__, _state, self.lexText);
             return TK_NUMBER;
         }
 
-        if ([_scanner scanCharacter:&ch]) {
-            if (_shouldShowLexing)                   CDLog(@"%s [state=%lu], token = %d '%c'", __PRETTY_FUNCTION__, _state, ch, ch);
-            return ch;
+        NSUInteger length;
+        uint32_t ch = [self characterAtOffset:_offset length:&length];
+        _offset += length;
+        if (ch > 0xFFFF) {
+            // One character, two tokens, like the UTF-16 units NSScanner handed out.
+            ch -= 0x10000;
+            _pendingLowSurrogate = (unichar)(0xDC00 + (ch & 0x3FF));
+            ch = 0xD800 + (ch >> 10);
         }
+        if (_shouldShowLexing)                       CDLog(@"%s [state=%lu], token = %d '%c'", __PRETTY_FUNCTION__, _state, ch, ch);
+        return (int)ch;
     }
 
     if (_shouldShowLexing)                           CDLog(@"%s [state=%lu], token = TK_EOS", __PRETTY_FUNCTION__, _state);
@@ -142,28 +309,61 @@ static NSString *CDTypeLexerStateName(CDTypeLexerState state)
     return TK_EOS;
 }
 
+// A lone '?', or an identifier start character followed by any number of identifier characters.
+- (NSUInteger)endOfIdentifierAtOffset:(NSUInteger)offset;
+{
+    if (offset >= _length)
+        return offset;
+
+    if (_bytes[offset] == '?')
+        return offset + 1;
+
+    NSUInteger length;
+    if ([self characterAtOffset:offset isInClasses:CDTypeLexerIdentifierStart length:&length] == NO)
+        return offset;
+
+    return [self endOfRunAtOffset:offset + length inClasses:CDTypeLexerIdentifier];
+}
+
+- (NSUInteger)scanLocation;
+{
+    // Count the UTF-16 units before the current offset: one per lead byte, two for characters outside the BMP.
+    NSUInteger location = 0;
+    for (NSUInteger index = 0; index < _offset; index++) {
+        uint8_t byte = _bytes[index];
+        if ((byte & 0xC0) != 0x80)
+            location += (byte >= 0xF0) ? 2 : 1;
+    }
+
+    return _pendingLowSurrogate != 0 ? location - 1 : location;
+}
+
 - (unichar)peekChar;
 {
-    return [_scanner peekChar];
+    if (_pendingLowSurrogate != 0)
+        return _pendingLowSurrogate;
+
+    if (_offset >= _length)
+        [NSException raise:NSRangeException format:@"%s: at end of type string", __PRETTY_FUNCTION__];
+
+    NSUInteger length;
+    uint32_t ch = [self characterAtOffset:_offset length:&length];
+    if (ch > 0xFFFF)
+        return (unichar)(0xD800 + ((ch - 0x10000) >> 10));
+
+    return (unichar)ch;
 }
 
 - (NSString *)remainingString;
 {
-    return [[_scanner string] substringFromIndex:[_scanner scanLocation]];
+    return [_string substringFromIndex:self.scanLocation];
 }
 
 - (NSString *)peekIdentifier;
 {
-    if (![_scanner string]){
-        CDLogVerbose(@"%s NSScanner initWithString: %@", __PRETTY_FUNCTION__, [_scanner string]);
-    }
-    NSScanner *peekScanner = [[NSScanner alloc] initWithString:[_scanner string]];
-    [peekScanner setScanLocation:[_scanner scanLocation]];
-
-    NSString *identifier;
-    if ([peekScanner scanIdentifierIntoString:&identifier]) {
-        return identifier;
-    }
+    NSUInteger end = [self endOfIdentifierAtOffset:_offset];
+    if (end > _offset)
+        return [[NSString alloc] initWithBytes:_bytes + _offset length:end - _offset encoding:NSUTF8StringEncoding];
 
     return nil;
 }
@@ -5,6 +5,8 @@
 
 #import <Foundation/Foundation.h>
 
+@class CDType;
+
 @interface CDTypeName : NSObject <NSCopying>
 
 @property (strong) NSString *name;
@@ -12,4 +14,7 @@
 @property (strong) NSString *suffix;
 @property (nonatomic, readonly) BOOL isTemplateType;
 
+// The type this is the name of, or whose name this is a template argument of.  Told when the name changes.
+@property (nonatomic, weak) CDType *owningType;
+
 @end
@@ -4,12 +4,14 @@
 //  Copyright (C) 1997-2019 Steve Nygard.
 
 #import <ClassDump/CDTypeName.h>
+#import <ClassDump/CDType.h>
 #import <ClassDump/ClassDumpUtils.h>
 @implementation CDTypeName
 {
     NSString *_name;
     NSMutableArray *_templateTypes;
     NSString *_suffix;
+    __weak CDType *_owningType;
 }
 
 - (instancetype)init;
@@ -41,6 +43,29 @@
 
 #pragma mark -
 
+- (NSString *)name;
+{
+    return _name;
+}
+
+// Renaming changes the type strings of the type that uses this name.  Setting the first name is part of building the type.
+- (void)setName:(NSString *)name;
+{
+    BOOL didChange = _name != nil && [_name isEqualToString:name] == NO;
+    _name = name;
+    if (didChange)
+        [_owningType typeNameDidChange];
+}
+
+- (void)setOwningType:(CDType *)owningType;
+{
+    _owningType = owningType;
+    for (CDTypeName *templateType in _templateTypes)
+        templateType.owningType = owningType;
+}
+
+#pragma mark -
+
 - (BOOL)isEqual:(id)otherObject;
 {
     if ([otherObject isKindOfClass:[self class]] == NO)
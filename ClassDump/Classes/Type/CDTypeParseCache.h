@@ -0,0 +1,40 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <Foundation/Foundation.h>
+#import <ClassDump/ClassDumpDefines.h>
+
+@class CDType;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef struct {
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t misses;        // Encodings that had to be parsed
+    uint64_t failures;      // Misses that didn't parse, these are cached too
+} CDTypeParseCacheStatistics;
+
+// Process-wide cache of parsed type encodings.  The same encodings turn up in every class of every image
+// (@"NSString", {CGRect=...}, v16@0:8), so each one is parsed once and the result is shared by all callers.
+// Safe to use from multiple threads.
+//
+// The returned types are shared, treat them as immutable.  Anything that needs to change a type (merging,
+// naming members, formatting) must work on a -copy, which is always a fresh parse.
+CD_PRIVATE
+@interface CDTypeParseCache : NSObject
+
++ (CDTypeParseCache *)sharedCache;
+
+// Returns an array of CDMethodType, or nil if the encoding can't be parsed.
+- (nullable NSArray *)methodTypesForEncoding:(NSString *)encoding error:(NSError **)error;
+- (nullable CDType *)typeForEncoding:(NSString *)encoding error:(NSError **)error;
+
+@property (readonly) CDTypeParseCacheStatistics statistics;
+- (NSString *)statisticsDescription;
+
+@end
+
+NS_ASSUME_NONNULL_END
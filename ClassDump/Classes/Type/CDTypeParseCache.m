@@ -0,0 +1,131 @@
+// -*- mode: ObjC -*-
+
+//  This file is part of class-dump, a utility for examining the Objective-C segment of Mach-O files.
+//  Copyright (C) 1997-2019 Steve Nygard.
+
+#import <ClassDump/CDTypeParseCache.h>
+
+#import <ClassDump/CDTypeParser.h>
+
+#include <os/lock.h>
+
+// Method types and single types are parsed differently, so they're cached separately.  Failed parses store
+// the NSError, so they aren't retried.
+@implementation CDTypeParseCache
+{
+    os_unfair_lock _lock;
+    NSMutableDictionary<NSString *, id> *_methodTypesByEncoding;
+    NSMutableDictionary<NSString *, id> *_typesByEncoding;
+    CDTypeParseCacheStatistics _statistics;
+}
+
++ (CDTypeParseCache *)sharedCache;
+{
+    static CDTypeParseCache *sharedCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCache = [[CDTypeParseCache alloc] init];
+    });
+
+    return sharedCache;
+}
+
+- (instancetype)init;
+{
+    if ((self = [super init])) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _methodTypesByEncoding = [[NSMutableDictionary alloc] init];
+        _typesByEncoding = [[NSMutableDictionary alloc] init];
+    }
+
+    return self;
+}
+
+#pragma mark -
+
+- (NSArray *)methodTypesForEncoding:(NSString *)encoding error:(NSError **)error;
+{
+    return [self resultForEncoding:encoding inDictionary:_methodTypesByEncoding error:error parse:^id(CDTypeParser *parser, NSError **parseError) {
+        return [parser parseMethodType:parseError];
+    }];
+}
+
+- (CDType *)typeForEncoding:(NSString *)encoding error:(NSError **)error;
+{
+    return [self resultForEncoding:encoding inDictionary:_typesByEncoding error:error parse:^id(CDTypeParser *parser, NSError **parseError) {
+        return [parser parseType:parseError];
+    }];
+}
+
+// The parse happens outside the lock.  Two threads can race to parse the same new encoding, in which case the
+// first one stored wins and both callers get it.
+- (id)resultForEncoding:(NSString *)encoding
+           inDictionary:(NSMutableDictionary<NSString *, id> *)dictionary
+                  error:(NSError **)error
+                  parse:(id (^)(CDTypeParser *parser, NSError **parseError))parse;
+{
+    os_unfair_lock_lock(&_lock);
+    id result = dictionary[encoding];
+    _statistics.lookups++;
+    if (result != nil)
+        _statistics.hits++;
+    os_unfair_lock_unlock(&_lock);
+
+    if (result == nil) {
+        CDTypeParser *parser = [[CDTypeParser alloc] initWithString:encoding];
+        NSError *parseError = nil;
+        id parsed = parse(parser, &parseError);
+        if (parsed == nil)
+            parsed = parseError != nil ? parseError : (id)[NSNull null];
+
+        os_unfair_lock_lock(&_lock);
+        result = dictionary[encoding];
+        if (result == nil) {
+            result = parsed;
+            dictionary[[encoding copy]] = result;
+            _statistics.misses++;
+            if ([result isKindOfClass:[NSError class]] || result == [NSNull null])
+                _statistics.failures++;
+        } else {
+            _statistics.hits++;
+        }
+        os_unfair_lock_unlock(&_lock);
+    }
+
+    if ([result isKindOfClass:[NSError class]]) {
+        if (error != NULL)
+            *error = result;
+        return nil;
+    }
+
+    if (result == [NSNull null])
+        return nil;
+
+    return result;
+}
+
+- (CDTypeParseCacheStatistics)statistics;
+{
+    os_unfair_lock_lock(&_lock);
+    CDTypeParseCacheStatistics statistics = _statistics;
+    os_unfair_lock_unlock(&_lock);
+
+    return statistics;
+}
+
+- (NSString *)statisticsDescription;
+{
+    CDTypeParseCacheStatistics statistics = self.statistics;
+    double hitRate = statistics.lookups > 0 ? 100.0 * statistics.hits / statistics.lookups : 0;
+    return [NSString stringWithFormat:@"type encodings: %llu lookups, %llu hits (%.1f%%), %llu misses, %llu failed to parse",
+            statistics.lookups, statistics.hits, hitRate, statistics.misses, statistics.failures];
+}
+
+#pragma mark - Debugging
+
+- (NSString *)description;
+{
+    return [NSString stringWithFormat:@"<%@:%p> %@", NSStringFromClass([self class]), self, [self statisticsDescription]];
+}
+
+@end
@@ -48,9 +48,10 @@ static NSString *CDTokenDescription(int token)
 - (instancetype)initWithString:(NSString *)string;
 {
     if ((self = [super init])) {
-        // Do some preprocessing first: Replace "<unnamed>::" with just "unnamed::".
-        NSMutableString *str = [string mutableCopy];
-        [str replaceOccurrencesOfString:@"<unnamed>::" withString:@"unnamed::" options:(NSStringCompareOptions)0 range:NSMakeRange(0, [string length])];
+        // Do some preprocessing first: Replace "<unnamed>::" with just "unnamed::".  Only copied when it's actually there.
+        NSString *str = string;
+        if (string != nil && [string rangeOfString:@"<unnamed>::"].location != NSNotFound)
+            str = [string stringByReplacingOccurrencesOfString:@"<unnamed>::" withString:@"unnamed::"];
         
         _lexer = [[CDTypeLexer alloc] initWithString:str];
         _lookahead = 0;
@@ -244,8 +245,8 @@ static NSString *CDTokenDescription(int token)
 #if 0
         if (lookahead == TK_QUOTED_STRING) {
             CDLog(@"%s, quoted string ahead, shouldCheckFieldNames: %d, end: %d",
-                  _cmd, shouldCheckFieldNames, [lexer.scanner isAtEnd]);
-            if ([lexer.scanner isAtEnd] == NO)
+                  _cmd, shouldCheckFieldNames, [lexer.remainingString length] == 0);
+            if ([lexer.remainingString length] != 0)
                 CDLog(@"next character: %d (%c), isInTypeStartSet: %d", lexer.peekChar, lexer.peekChar, [self isTokenInTypeStartSet:lexer.peekChar]);
         }
 #endif
@@ -13,6 +13,15 @@
 #import <ClassDump/CDTypeController.h>
 #import <ClassDump/ClassDumpUtils.h>
 #import <ClassDump/CDClassDumpConfiguration.h>
+#import <ClassDump/NSData-CDExtensions.h>
+
+// Records what the previous run wrote into the output directory, when only changed files are written.
+static NSString *const CDOutputManifestFilename = @".class-dump-manifest.plist";
+static NSString *const CDOutputManifestKey_Version = @"Version";
+static NSString *const CDOutputManifestKey_Files = @"Files";
+static NSString *const CDOutputManifestFileKey_Hash = @"Hash";
+static NSString *const CDOutputManifestFileKey_ModificationDate = @"ModificationDate";
+static const NSInteger CDOutputManifestVersion = 1;
 
 @interface CDMultipleFileVisitor ()
 
@@ -41,6 +50,12 @@
 
 @property (strong) NSMutableString *implementationString;
 
+// Output filename -> manifest entry, for skipping unchanged files and removing stale ones.
+@property (strong) NSDictionary<NSString *, NSDictionary *> *previousManifestFiles;
+@property (readonly) NSMutableDictionary<NSString *, NSDictionary *> *manifestFiles;
+@property (assign) NSUInteger writtenFileCount;
+@property (assign) NSUInteger unchangedFileCount;
+
 @end
 
 #pragma mark -
@@ -54,6 +69,7 @@
         _weaklyReferencedProtocolNames = [[NSMutableSet alloc] init];
         _fileNamesByProtocolName = [NSMutableDictionary dictionary];
         _implementationString = [NSMutableString string];
+        _manifestFiles = [NSMutableDictionary dictionary];
     }
 
     return self;
@@ -70,6 +86,7 @@
     if (self.classDump.hasObjectiveCRuntimeInfo) {
         [self buildClassFrameworks];
         [self createOutputPathIfNecessary];
+        [self loadOutputManifest];
         [self generateStructureHeader];
     } else {
         // TODO: (2007-06-14) Make sure this generates no output files in this case.
@@ -77,6 +94,14 @@
     }
 }
 
+- (void)didEndVisiting; {
+    [super didEndVisiting];
+
+    if (self.classDump.hasObjectiveCRuntimeInfo) {
+        [self finishOutputManifest];
+    }
+}
+
 - (void)willVisitClass:(CDOCClass *)aClass; {
     // First, we set up some context...
     [self.resultString setString:@""];
@@ -115,11 +140,7 @@
 
     NSString *filename = [NSString stringWithFormat:@"%@.h", aClass.name];
 
-    if (self.outputPath != nil) {
-        filename = [self.outputPath stringByAppendingPathComponent:filename];
-    }
-
-    [[self.resultString dataUsingEncoding:NSUTF8StringEncoding] writeToFile:filename atomically:YES];
+    [self writeString:self.resultString toOutputFile:filename];
     
     if (self.classDump.configuration.shouldGenerateEmptyImplementationFile) {
         [self.implementationString setString:@""];
@@ -130,8 +151,7 @@
         [self.implementationString appendString:@"\n"];
         [self.implementationString appendString:@"\n"];
         [self.implementationString appendString:@"@end"];
-        NSString *implFilePath = [self.outputPath stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.m", aClass.name]];
-        [[self.implementationString dataUsingEncoding:NSUTF8StringEncoding] writeToFile:implFilePath atomically:YES];
+        [self writeString:self.implementationString toOutputFile:[NSString stringWithFormat:@"%@.m", aClass.name]];
     }
 }
 
@@ -178,11 +198,7 @@
         filename = [NSString stringWithFormat:@"%@+%@.h", category.className, category.name];
     }
 
-    if (self.outputPath != nil) {
-        filename = [self.outputPath stringByAppendingPathComponent:filename];
-    }
-
-    [[self.resultString dataUsingEncoding:NSUTF8StringEncoding] writeToFile:filename atomically:YES];
+    [self writeString:self.resultString toOutputFile:filename];
     
     if (self.classDump.configuration.shouldGenerateEmptyImplementationFile) {
         [self.implementationString setString:@""];
@@ -194,8 +210,8 @@
         [self.implementationString appendString:@"\n"];
         [self.implementationString appendString:@"@end"];
         
-        NSString *implFilePath = [self.outputPath stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.m", [filename.lastPathComponent stringByDeletingPathExtension]]];
-        [[self.implementationString dataUsingEncoding:NSUTF8StringEncoding] writeToFile:implFilePath atomically:YES];
+        NSString *implFilename = [NSString stringWithFormat:@"%@.m", [filename.lastPathComponent stringByDeletingPathExtension]];
+        [self writeString:self.implementationString toOutputFile:implFilename];
     }
 }
 
@@ -235,11 +251,7 @@
 
     self.fileNamesByProtocolName[protocol.name] = filename;
 
-    if (self.outputPath != nil) {
-        filename = [self.outputPath stringByAppendingPathComponent:filename];
-    }
-
-    [[self.resultString dataUsingEncoding:NSUTF8StringEncoding] writeToFile:filename atomically:YES];
+    [self writeString:self.resultString toOutputFile:filename];
 }
 
 #pragma mark - CDTypeControllerDelegate
@@ -447,11 +459,124 @@
         filename = @"CDStructures.h";
     }
 
+    [self writeString:self.resultString toOutputFile:filename];
+}
+
+#pragma mark - Output files
+
+- (NSString *)pathForOutputFile:(NSString *)filename; {
     if (self.outputPath != nil) {
-        filename = [self.outputPath stringByAppendingPathComponent:filename];
+        return [self.outputPath stringByAppendingPathComponent:filename];
+    }
+
+    return filename;
+}
+
+// Writes the file, unless incremental output is on and the file already has exactly these contents.  The manifest
+// lets most unchanged files be skipped without reading them back: the hash still matches and the file hasn't been
+// touched since it was written.
+- (void)writeString:(NSString *)string toOutputFile:(NSString *)filename; {
+    NSString *path = [self pathForOutputFile:filename];
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+
+    if (self.classDump.configuration.shouldWriteOnlyChangedFiles == NO) {
+        [data writeToFile:path atomically:YES];
+        return;
+    }
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *hash = [NSString stringWithFormat:@"%016llx", data.FNV1aHash];
+    NSDictionary *attributes = [fileManager attributesOfItemAtPath:path error:NULL];
+    BOOL isUnchanged = NO;
+
+    if (attributes != nil && [attributes fileSize] == [data length]) {
+        NSDictionary *previousEntry = self.previousManifestFiles[filename];
+
+        if ([previousEntry[CDOutputManifestFileKey_Hash] isEqual:hash] && [previousEntry[CDOutputManifestFileKey_ModificationDate] isEqual:[attributes fileModificationDate]]) {
+            isUnchanged = YES;
+        } else {
+            isUnchanged = [[NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:NULL] isEqualToData:data];
+        }
+    }
+
+    if (isUnchanged) {
+        self.unchangedFileCount++;
+    } else {
+        NSError *error = nil;
+
+        if ([data writeToFile:path options:NSDataWritingAtomic error:&error] == NO) {
+            CDLogError(@"Couldn't write %@: %@", path, error);
+            // Keep the previous copy, if there was one.  The next run finds it out of date and writes it again.
+            self.manifestFiles[filename] = self.previousManifestFiles[filename];
+            return;
+        }
+
+        attributes = [fileManager attributesOfItemAtPath:path error:NULL];
+        self.writtenFileCount++;
+    }
+
+    NSMutableDictionary *entry = [NSMutableDictionary dictionary];
+    entry[CDOutputManifestFileKey_Hash] = hash;
+    entry[CDOutputManifestFileKey_ModificationDate] = [attributes fileModificationDate];
+    self.manifestFiles[filename] = entry;
+}
+
+- (void)loadOutputManifest; {
+    if (self.classDump.configuration.shouldWriteOnlyChangedFiles == NO) {
+        return;
+    }
+
+    NSData *data = [NSData dataWithContentsOfFile:[self pathForOutputFile:CDOutputManifestFilename]];
+    NSDictionary *manifest = nil;
+
+    if (data != nil) {
+        manifest = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    }
+
+    if ([manifest isKindOfClass:[NSDictionary class]] && [manifest[CDOutputManifestKey_Version] isEqual:@(CDOutputManifestVersion)] && [manifest[CDOutputManifestKey_Files] isKindOfClass:[NSDictionary class]]) {
+        self.previousManifestFiles = manifest[CDOutputManifestKey_Files];
+    } else {
+        self.previousManifestFiles = @{};
+    }
+}
+
+// Removes files the previous run wrote that this run didn't, such as headers for classes that have gone away, then
+// saves the manifest for the next run.  Only files listed in the manifest are ever removed.
+- (void)finishOutputManifest; {
+    if (self.classDump.configuration.shouldWriteOnlyChangedFiles == NO) {
+        return;
+    }
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSUInteger removedFileCount = 0;
+
+    for (NSString *filename in [[self.previousManifestFiles allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        if (self.manifestFiles[filename] == nil && [filename isAbsolutePath] == NO && [[filename pathComponents] containsObject:@".."] == NO) {
+            NSError *error = nil;
+            NSString *path = [self pathForOutputFile:filename];
+
+            if ([fileManager removeItemAtPath:path error:&error]) {
+                removedFileCount++;
+            } else if ([fileManager fileExistsAtPath:path]) {
+                CDLogError(@"Couldn't remove stale file %@: %@", path, error);
+            }
+        }
+    }
+
+    if ([self.manifestFiles isEqualToDictionary:self.previousManifestFiles] == NO) {
+        NSDictionary *manifest = @{
+            CDOutputManifestKey_Version : @(CDOutputManifestVersion),
+            CDOutputManifestKey_Files   : self.manifestFiles,
+        };
+        NSError *error = nil;
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:manifest format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+
+        if (data == nil || [data writeToFile:[self pathForOutputFile:CDOutputManifestFilename] options:NSDataWritingAtomic error:&error] == NO) {
+            CDLogError(@"Couldn't write output manifest: %@", error);
+        }
     }
 
-    [[self.resultString dataUsingEncoding:NSUTF8StringEncoding] writeToFile:filename atomically:YES];
+    CDLogVerbose(@"Output: %lu written, %lu unchanged, %lu removed", self.writtenFileCount, self.unchangedFileCount, removedFileCount);
 }
 
 
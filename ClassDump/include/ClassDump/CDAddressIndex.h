@@ -0,0 +1 @@
+../../Classes/Structure/CDAddressIndex.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../Classes/FileManagement/CDDataView.h
\ No newline at end of file
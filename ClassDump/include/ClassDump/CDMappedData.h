@@ -0,0 +1 @@
+../../Classes/FileManagement/CDMappedData.h
\ No newline at end of file
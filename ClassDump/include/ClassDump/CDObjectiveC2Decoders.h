@@ -0,0 +1 @@
+../../Classes/ObjC/CDObjectiveC2Decoders.h
\ No newline at end of file
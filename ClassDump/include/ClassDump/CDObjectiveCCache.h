@@ -0,0 +1 @@
+../../Classes/ObjC/CDObjectiveCCache.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../Classes/Cursors/CDSpanCursor.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../Classes/Structure/CDStringPool.h
\ No newline at end of file
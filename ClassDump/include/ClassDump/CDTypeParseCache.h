@@ -0,0 +1 @@
+../../Classes/Type/CDTypeParseCache.h
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #import <XCTest/XCTest.h>
 #import <ClassDump/ClassDump.h>
+#import <ClassDump/CDObjectiveCCache.h>
 #import <AppKit/AppKit.h>
 
 
@@ -88,6 +89,121 @@
     [[NSWorkspace sharedWorkspace] activateFileViewerSelectingURLs:@[dumpToURL]];
 }
 
+- (NSString *)supportFrameworkExecutablePath {
+    NSURL *currentSourceFileURL = [NSURL fileURLWithPath:@__FILE__];
+    return [[currentSourceFileURL URLByDeletingLastPathComponent] URLByAppendingPathComponent:@"ClassDumpTestsSupport.framework/Versions/A/ClassDumpTestsSupport"].path;
+}
+
+- (NSString *)temporaryDirectoryWithName:(NSString *)name {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"ClassDumpTests-%@-%@", name, [[NSUUID UUID] UUIDString]]];
+    [self addTeardownBlock:^{
+        [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    }];
+    return path;
+}
+
+// Dumps the support framework into outputPath as separate headers, the same way testExample does.  Returns the
+// class dump, or nil if the framework couldn't be loaded.
+- (CDClassDump *)dumpSupportFrameworkToPath:(NSString *)outputPath configure:(void (^)(CDClassDumpConfiguration *configuration))configure {
+    CDClassDump *classDump = [self classDumpInstanceFromFile:[self supportFrameworkExecutablePath]];
+    if (!classDump) {
+        XCTFail(@"couldnt create class dump instance for file: %@", [self supportFrameworkExecutablePath]);
+        return nil;
+    }
+    CDClassDumpConfiguration *configuration = [CDClassDumpConfiguration new];
+    configuration.shouldShowIvarOffsets = YES;
+    configuration.shouldStripOverrides = YES;
+    configuration.shouldStripSynthesized = YES;
+    if (configure)
+        configure(configuration);
+    [classDump.configuration applyConfiguration:configuration];
+    [classDump processObjectiveCData];
+    [classDump registerTypes];
+    CDMultipleFileVisitor *multiFileVisitor = [[CDMultipleFileVisitor alloc] init];
+    multiFileVisitor.classDump = classDump;
+    multiFileVisitor.outputPath = outputPath;
+    classDump.typeController.delegate = multiFileVisitor;
+    [classDump recursivelyVisit:multiFileVisitor];
+    return classDump;
+}
+
+- (NSDictionary<NSString *, NSData *> *)contentsOfHeadersAtPath:(NSString *)path {
+    NSMutableDictionary<NSString *, NSData *> *contents = [NSMutableDictionary dictionary];
+    for (NSString *filename in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:path error:NULL]) {
+        if ([filename.pathExtension isEqualToString:@"h"])
+            contents[filename] = [NSData dataWithContentsOfFile:[path stringByAppendingPathComponent:filename]];
+    }
+    return contents;
+}
+
+- (void)testObjectiveCCacheRoundTrip {
+    NSString *cachePath = [self temporaryDirectoryWithName:@"Cache"];
+    NSString *coldPath = [self temporaryDirectoryWithName:@"Cold"];
+    NSString *warmPath = [self temporaryDirectoryWithName:@"Warm"];
+    void (^useCache)(CDClassDumpConfiguration *) = ^(CDClassDumpConfiguration *configuration) {
+        configuration.objectiveCCacheDirectory = cachePath;
+    };
+
+    XCTAssertNotNil([self dumpSupportFrameworkToPath:coldPath configure:useCache]);
+    NSArray<NSString *> *entries = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:cachePath error:NULL];
+    XCTAssertTrue([[entries filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF ENDSWITH '.cdcache'"]] count] > 0, @"cold run didn't write a cache entry");
+
+    CDClassDump *warmClassDump = [self dumpSupportFrameworkToPath:warmPath configure:useCache];
+    XCTAssertNotNil(warmClassDump);
+    CDObjectiveCCacheStatistics statistics = warmClassDump.objectiveCCache.statistics;
+    XCTAssertTrue(statistics.hits > 0, @"warm run didn't load anything from the cache");
+    XCTAssertEqual(statistics.misses, 0ull);
+    XCTAssertEqual(statistics.rejected, 0ull);
+
+    // Byte for byte, including the #import lines that depend on how external classes were resolved.
+    NSDictionary<NSString *, NSData *> *coldHeaders = [self contentsOfHeadersAtPath:coldPath];
+    NSDictionary<NSString *, NSData *> *warmHeaders = [self contentsOfHeadersAtPath:warmPath];
+    XCTAssertTrue([coldHeaders count] > 0);
+    XCTAssertEqualObjects([[coldHeaders allKeys] sortedArrayUsingSelector:@selector(compare:)], [[warmHeaders allKeys] sortedArrayUsingSelector:@selector(compare:)]);
+    for (NSString *filename in coldHeaders) {
+        XCTAssertEqualObjects(coldHeaders[filename], warmHeaders[filename], @"%@ differs when loaded from the cache", filename);
+    }
+}
+
+- (void)testWriteOnlyChangedFiles {
+    NSString *outputPath = [self temporaryDirectoryWithName:@"Incremental"];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    void (^incremental)(CDClassDumpConfiguration *) = ^(CDClassDumpConfiguration *configuration) {
+        configuration.shouldWriteOnlyChangedFiles = YES;
+    };
+
+    XCTAssertNotNil([self dumpSupportFrameworkToPath:outputPath configure:incremental]);
+    NSDictionary<NSString *, NSData *> *headers = [self contentsOfHeadersAtPath:outputPath];
+    XCTAssertTrue([headers count] > 0);
+
+    // Backdate everything, so a rewrite can't land on the same modification date.
+    NSDate *backdated = [NSDate dateWithTimeIntervalSinceReferenceDate:0];
+    for (NSString *filename in headers) {
+        XCTAssertTrue([fileManager setAttributes:@{ NSFileModificationDate : backdated } ofItemAtPath:[outputPath stringByAppendingPathComponent:filename] error:NULL]);
+    }
+
+    // A header the previous run wrote for a class that has since disappeared, and one the manifest doesn't know about.
+    NSString *manifestPath = [outputPath stringByAppendingPathComponent:@".class-dump-manifest.plist"];
+    NSMutableDictionary *manifest = [[NSPropertyListSerialization propertyListWithData:[NSData dataWithContentsOfFile:manifestPath] options:NSPropertyListMutableContainers format:NULL error:NULL] mutableCopy];
+    XCTAssertNotNil(manifest);
+    NSString *staleFilename = @"CDTestObjectRemoved.h";
+    NSString *unrelatedFilename = @"NotGenerated.h";
+    XCTAssertTrue([[@"@interface CDTestObjectRemoved\n@end\n" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:[outputPath stringByAppendingPathComponent:staleFilename] atomically:YES]);
+    XCTAssertTrue([[@"// Not ours\n" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:[outputPath stringByAppendingPathComponent:unrelatedFilename] atomically:YES]);
+    manifest[@"Files"][staleFilename] = @{ @"Hash" : @"0000000000000000" };
+    XCTAssertTrue([[NSPropertyListSerialization dataWithPropertyList:manifest format:NSPropertyListBinaryFormat_v1_0 options:0 error:NULL] writeToFile:manifestPath atomically:YES]);
+
+    XCTAssertNotNil([self dumpSupportFrameworkToPath:outputPath configure:incremental]);
+
+    for (NSString *filename in headers) {
+        NSString *path = [outputPath stringByAppendingPathComponent:filename];
+        XCTAssertEqualObjects([[fileManager attributesOfItemAtPath:path error:NULL] fileModificationDate], backdated, @"%@ was rewritten", filename);
+        XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], headers[filename]);
+    }
+    XCTAssertFalse([fileManager fileExistsAtPath:[outputPath stringByAppendingPathComponent:staleFilename]], @"stale header wasn't removed");
+    XCTAssertTrue([fileManager fileExistsAtPath:[outputPath stringByAppendingPathComponent:unrelatedFilename]], @"removed a file the manifest didn't list");
+}
+
 //- (void)testDumpFramework {
 //    @autoreleasepool {
 //        NSURL *dumpFromURL = [NSURL fileURLWithPath:@"/Volumes/FrameworkLab/Numbers/Frameworks/TSTables.framework/Versions/A/TSTables"];